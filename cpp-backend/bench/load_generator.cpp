@@ -0,0 +1,376 @@
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cerrno>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+using json = nlohmann::json;
+using Clock = std::chrono::steady_clock;
+
+// HTTP load generator for stock_server.
+//
+// Closed loop: each connection sends its next request as soon as the previous one completes.
+// Open loop: requests are scheduled at a fixed rate; latency is measured from the scheduled
+// send time, so a stalled server is charged for the requests it delayed (no coordinated omission).
+//
+// Usage: load_generator [--host 127.0.0.1] [--port 3000] [--endpoint order|orders|trade|price|mix]
+//                       [--mode closed|open] [--connections 8] [--duration 10] [--warmup 2]
+//                       [--rate 1000] [--timeout 35] [--seed-orders 1] [--label name] [--out results.json]
+// --seed-orders places that many orders before the run, so /api/orders starts from a known
+// history size. --timeout bounds every connect/send/recv in seconds. In status_counts, -1 is an I/O
+// failure and -2 a timeout. Results are written as JSON so runs can be diffed between commits.
+
+struct Options {
+    std::string host = "127.0.0.1";
+    int port = 3000;
+    std::string endpoint = "mix";
+    std::string mode = "closed";
+    int connections = 8;
+    double duration = 10.0;
+    double warmup = 2.0;
+    double rate = 1000.0;
+    // Longer than stock_server's own /api/trade deadline, so its 504s are seen rather than masked
+    double timeout = 35.0;
+    // Orders placed before the run; at least one so /api/price has a last price
+    int seed_orders = 1;
+    std::string label;
+    std::string out;
+};
+
+struct Request {
+    std::string name;
+    std::string raw;
+};
+
+// Per-thread results, merged after the run
+struct Samples {
+    std::map<std::string, std::vector<std::int64_t>> latency_ns;
+    std::map<std::string, std::uint64_t> errors;
+    std::map<int, std::uint64_t> status_counts;
+};
+
+std::string buildRequest(const std::string& method, const std::string& path, const Options& opt, const std::string& body = "") {
+    std::string req = method + " " + path + " HTTP/1.1\r\n";
+    req += "Host: " + opt.host + ":" + std::to_string(opt.port) + "\r\n";
+    req += "Connection: keep-alive\r\n";
+    if (!body.empty()) {
+        req += "Content-Type: application/json\r\n";
+        req += "Content-Length: " + std::to_string(body.size()) + "\r\n";
+    }
+    req += "\r\n" + body;
+    return req;
+}
+
+const char* kOrderBody = R"({"symbol":"AAPL","quantity":10,"type":"buy","timestamp":"2024-01-01T00:00:00Z"})";
+
+std::vector<Request> buildRequests(const Options& opt) {
+    Request order{"order", buildRequest("POST", "/api/order", opt, kOrderBody)};
+    Request orders{"orders", buildRequest("GET", "/api/orders", opt)};
+    Request trade{"trade", buildRequest("POST", "/api/trade", opt,
+        R"({"pair":"BTC-USD","side":"buy","quantity":0.01})")};
+    Request price{"price", buildRequest("GET", "/api/price/AAPL", opt)};
+    if (opt.endpoint == "order") return {order};
+    if (opt.endpoint == "orders") return {orders};
+    if (opt.endpoint == "trade") return {trade};
+    if (opt.endpoint == "price") return {price};
+    return {order, orders, trade, price};
+}
+
+class Connection {
+public:
+    explicit Connection(const Options& opt) : opt_(opt) {}
+    ~Connection() { close(); }
+
+    static constexpr int kIoError = -1;
+    static constexpr int kTimedOut = -2;
+
+    // Sends one request and reads the full response; returns the HTTP status, kIoError or kTimedOut
+    int roundTrip(const std::string& request) {
+        timed_out_ = false;
+        if (fd_ < 0 && !connect()) return failure();
+        if (!sendAll(request)) {
+            if (timed_out_) return failure();
+            // The server may have closed an idle keep-alive connection; retry once on a fresh one
+            close();
+            if (!connect() || !sendAll(request)) return failure();
+        }
+        int status = readResponse();
+        // A late response would be read as the answer to the next request, so drop the connection
+        if (status < 0) return failure();
+        return status;
+    }
+
+private:
+    const Options& opt_;
+    int fd_ = -1;
+    bool timed_out_ = false;
+    std::string buffer_;
+
+    int failure() {
+        close();
+        return timed_out_ ? kTimedOut : kIoError;
+    }
+
+    void noteError() {
+        if (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINPROGRESS) timed_out_ = true;
+    }
+
+    bool connect() {
+        fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        if (fd_ < 0) return false;
+        int one = 1;
+        setsockopt(fd_, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+        // Bounds connect and send (SO_SNDTIMEO) and every recv (SO_RCVTIMEO), so a hung server cannot stall the run
+        timeval tv{};
+        tv.tv_sec = static_cast<time_t>(opt_.timeout);
+        tv.tv_usec = static_cast<suseconds_t>((opt_.timeout - static_cast<double>(tv.tv_sec)) * 1e6);
+        setsockopt(fd_, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+        setsockopt(fd_, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_port = htons(static_cast<uint16_t>(opt_.port));
+        inet_pton(AF_INET, opt_.host.c_str(), &addr.sin_addr);
+        if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) < 0) {
+            noteError();
+            close();
+            return false;
+        }
+        buffer_.clear();
+        return true;
+    }
+
+    void close() {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+    bool sendAll(const std::string& data) {
+        std::size_t sent = 0;
+        while (sent < data.size()) {
+            ssize_t n = ::send(fd_, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                if (n < 0) noteError();
+                return false;
+            }
+            sent += static_cast<std::size_t>(n);
+        }
+        return true;
+    }
+
+    bool fill() {
+        char chunk[16384];
+        ssize_t n = ::recv(fd_, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+            if (n < 0) noteError();
+            return false;
+        }
+        buffer_.append(chunk, static_cast<std::size_t>(n));
+        return true;
+    }
+
+    int readResponse() {
+        std::size_t header_end;
+        while ((header_end = buffer_.find("\r\n\r\n")) == std::string::npos) {
+            if (!fill()) return -1;
+        }
+        std::string headers = buffer_.substr(0, header_end);
+        int status = -1;
+        if (headers.size() > 12) status = std::atoi(headers.c_str() + 9);
+
+        std::size_t content_length = 0;
+        std::string lower = headers;
+        std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+        std::size_t pos = lower.find("content-length:");
+        if (pos != std::string::npos) content_length = std::strtoul(lower.c_str() + pos + 15, nullptr, 10);
+
+        std::size_t total = header_end + 4 + content_length;
+        while (buffer_.size() < total) {
+            if (!fill()) return -1;
+        }
+        buffer_.erase(0, total);
+        return status;
+    }
+};
+
+void worker(const Options& opt, const std::vector<Request>& requests, int worker_id,
+            Clock::time_point start, Clock::time_point measure_from, Clock::time_point stop, Samples& samples) {
+    Connection conn(opt);
+    std::size_t next = static_cast<std::size_t>(worker_id);
+    bool open_loop = opt.mode == "open";
+    // Each connection carries an equal share of the target rate, staggered across workers
+    auto interval = std::chrono::nanoseconds(open_loop ? static_cast<std::int64_t>(1e9 * opt.connections / opt.rate) : 0);
+    auto scheduled = start + interval * worker_id / std::max(1, opt.connections);
+
+    while (true) {
+        if (open_loop) {
+            if (scheduled >= stop) break;
+            std::this_thread::sleep_until(scheduled);
+        } else if (Clock::now() >= stop) {
+            break;
+        }
+        const Request& req = requests[next++ % requests.size()];
+        auto sent = open_loop ? scheduled : Clock::now();
+        int status = conn.roundTrip(req.raw);
+        auto done = Clock::now();
+        if (open_loop) scheduled += interval;
+
+        if (sent < measure_from) continue;
+        samples.status_counts[status]++;
+        if (status < 200 || status >= 300) {
+            samples.errors[req.name]++;
+            continue;
+        }
+        samples.latency_ns[req.name].push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(done - sent).count());
+    }
+}
+
+json summarize(std::vector<std::int64_t>& latencies, std::uint64_t errors, double seconds) {
+    std::sort(latencies.begin(), latencies.end());
+    auto pct = [&](double p) -> double {
+        if (latencies.empty()) return 0.0;
+        std::size_t idx = std::min(latencies.size() - 1, static_cast<std::size_t>(p * latencies.size()));
+        return latencies[idx] / 1e3;
+    };
+    double sum = 0.0;
+    for (auto v : latencies) sum += static_cast<double>(v);
+    json result;
+    result["requests"] = latencies.size() + errors;
+    result["ok"] = latencies.size();
+    result["errors"] = errors;
+    result["throughput_rps"] = latencies.size() / seconds;
+    result["latency_us"] = {
+        {"min", latencies.empty() ? 0.0 : latencies.front() / 1e3},
+        {"mean", latencies.empty() ? 0.0 : sum / latencies.size() / 1e3},
+        {"p50", pct(0.50)},
+        {"p90", pct(0.90)},
+        {"p99", pct(0.99)},
+        {"p999", pct(0.999)},
+        {"max", latencies.empty() ? 0.0 : latencies.back() / 1e3}
+    };
+    return result;
+}
+
+bool parseArgs(int argc, char* argv[], Options& opt) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            std::cerr << "Missing value for " << arg << std::endl;
+            return false;
+        }
+        std::string value = argv[++i];
+        if (arg == "--host") opt.host = value;
+        else if (arg == "--port") opt.port = std::atoi(value.c_str());
+        else if (arg == "--endpoint") opt.endpoint = value;
+        else if (arg == "--mode") opt.mode = value;
+        else if (arg == "--connections") opt.connections = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--duration") opt.duration = std::atof(value.c_str());
+        else if (arg == "--warmup") opt.warmup = std::atof(value.c_str());
+        else if (arg == "--rate") opt.rate = std::atof(value.c_str());
+        else if (arg == "--timeout") opt.timeout = std::atof(value.c_str());
+        else if (arg == "--seed-orders") opt.seed_orders = std::max(1, std::atoi(value.c_str()));
+        else if (arg == "--label") opt.label = value;
+        else if (arg == "--out") opt.out = value;
+        else {
+            std::cerr << "Unknown option " << arg << std::endl;
+            return false;
+        }
+    }
+    if (opt.mode != "closed" && opt.mode != "open") {
+        std::cerr << "--mode must be closed or open" << std::endl;
+        return false;
+    }
+    if (opt.timeout <= 0.0) {
+        std::cerr << "--timeout must be positive" << std::endl;
+        return false;
+    }
+    if (opt.mode == "open" && opt.rate <= 0.0) {
+        std::cerr << "--rate must be positive in open-loop mode" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[]) {
+    Options opt;
+    if (!parseArgs(argc, argv, opt)) return 1;
+    std::vector<Request> requests = buildRequests(opt);
+
+    // Seed the order history; this also primes the last price /api/price returns
+    {
+        Connection conn(opt);
+        std::string seed = buildRequest("POST", "/api/order", opt, kOrderBody);
+        for (int i = 0; i < opt.seed_orders; ++i) {
+            if (conn.roundTrip(seed) < 0) {
+                std::cerr << "Cannot reach " << opt.host << ":" << opt.port << std::endl;
+                return 1;
+            }
+        }
+    }
+
+    auto start = Clock::now();
+    auto measure_from = start + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(opt.warmup));
+    auto stop = measure_from + std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(opt.duration));
+
+    std::vector<Samples> samples(static_cast<std::size_t>(opt.connections));
+    std::vector<std::thread> threads;
+    for (int i = 0; i < opt.connections; ++i) {
+        threads.emplace_back(worker, std::cref(opt), std::cref(requests), i, start, measure_from, stop, std::ref(samples[i]));
+    }
+    for (auto& t : threads) t.join();
+
+    // Merge per-thread samples
+    std::map<std::string, std::vector<std::int64_t>> latency;
+    std::map<std::string, std::uint64_t> errors;
+    std::map<int, std::uint64_t> statuses;
+    for (auto& s : samples) {
+        for (auto& entry : s.latency_ns) {
+            auto& dst = latency[entry.first];
+            dst.insert(dst.end(), entry.second.begin(), entry.second.end());
+        }
+        for (auto& entry : s.errors) errors[entry.first] += entry.second;
+        for (auto& entry : s.status_counts) statuses[entry.first] += entry.second;
+    }
+
+    json report;
+    report["label"] = opt.label;
+    report["config"] = {
+        {"host", opt.host}, {"port", opt.port}, {"endpoint", opt.endpoint}, {"mode", opt.mode},
+        {"connections", opt.connections}, {"duration_s", opt.duration}, {"warmup_s", opt.warmup},
+        {"rate_rps", opt.mode == "open" ? opt.rate : 0.0}, {"timeout_s", opt.timeout},
+        {"seed_orders", opt.seed_orders}
+    };
+    std::vector<std::int64_t> all;
+    std::uint64_t all_errors = 0;
+    for (const auto& req : requests) {
+        auto& lat = latency[req.name];
+        all.insert(all.end(), lat.begin(), lat.end());
+        all_errors += errors[req.name];
+        report["endpoints"][req.name] = summarize(lat, errors[req.name], opt.duration);
+    }
+    report["total"] = summarize(all, all_errors, opt.duration);
+    for (const auto& entry : statuses) report["status_counts"][std::to_string(entry.first)] = entry.second;
+
+    std::string out = report.dump(2);
+    if (opt.out.empty()) {
+        std::cout << out << std::endl;
+    } else {
+        std::ofstream file(opt.out);
+        file << out << std::endl;
+        std::cerr << "Wrote " << opt.out << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,151 @@
+#include <benchmark/benchmark.h>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+#include "order_book.h"
+#include "order_history.h"
+#include "coinbase_api.h"
+#include "kraken_api.h"
+#include "gemini_api.h"
+#include "position_engine.h"
+#include "arbitrage_monitor.h"
+#include "spsc_ring.h"
+
+// Microbenchmarks for the hot paths behind the HTTP routes.
+// Run with --benchmark_format=json (or --benchmark_out=<file>) to get diffable results.
+
+namespace {
+
+// Venue book with `levels` price levels per side, in the [price, size] string format venues return
+nlohmann::json makeBook(int levels, double mid) {
+    nlohmann::json book;
+    book["bids"] = nlohmann::json::array();
+    book["asks"] = nlohmann::json::array();
+    for (int i = 0; i < levels; ++i) {
+        book["bids"].push_back({std::to_string(mid - 0.01 * (i + 1)), std::to_string(0.5 + i % 7)});
+        book["asks"].push_back({std::to_string(mid + 0.01 * (i + 1)), std::to_string(0.5 + i % 5)});
+    }
+    return book;
+}
+
+} // namespace
+
+static void BM_ParseBookJson(benchmark::State& state) {
+    std::string raw = makeBook(static_cast<int>(state.range(0)), 50000.0).dump();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(nlohmann::json::parse(raw));
+    }
+    state.SetBytesProcessed(static_cast<int64_t>(state.iterations()) * static_cast<int64_t>(raw.size()));
+}
+BENCHMARK(BM_ParseBookJson)->Arg(10)->Arg(50)->Arg(1000);
+
+static void BM_ParseTopOfBook(benchmark::State& state) {
+    nlohmann::json book = makeBook(50, 50000.0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(OrderBook::parseTopOfBook(Venue::Coinbase, book));
+    }
+}
+BENCHMARK(BM_ParseTopOfBook);
+
+static void BM_MergeOrderBooks(benchmark::State& state) {
+    OrderBook ob(nullptr, nullptr, nullptr);
+    int levels = static_cast<int>(state.range(0));
+    std::vector<nlohmann::json> books = {
+        makeBook(levels, 50000.0), makeBook(levels, 50000.5), makeBook(levels, 49999.5)
+    };
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(ob.mergeOrderBooks("BTC-USD", books));
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * levels * 6);
+}
+BENCHMARK(BM_MergeOrderBooks)->Arg(10)->Arg(50)->Arg(1000);
+
+static void BM_CoinbaseSign(benchmark::State& state) {
+    CoinbaseAPI api("key", "c2VjcmV0LXNlY3JldC1zZWNyZXQ=", "pass");
+    std::string body = R"({"type":"market","side":"buy","product_id":"BTC-USD","size":0.5})";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(api.signRequest("POST", "/orders", body, "1700000000"));
+    }
+}
+BENCHMARK(BM_CoinbaseSign);
+
+static void BM_KrakenSign(benchmark::State& state) {
+    KrakenAPI api("key", "c2VjcmV0LXNlY3JldC1zZWNyZXQ=");
+    std::string postdata = "nonce=1700000000&pair=\"XBTUSD\"&type=\"buy\"&ordertype=\"market\"&volume=0.5";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(api.signRequest("/0/private/AddOrder", "1700000000", postdata));
+    }
+}
+BENCHMARK(BM_KrakenSign);
+
+static void BM_GeminiSign(benchmark::State& state) {
+    GeminiAPI api("key", "secret-secret-secret");
+    std::string payload = "eyJyZXF1ZXN0IjoiL3YxL29yZGVyL25ldyIsIm5vbmNlIjoiMTcwMDAwMDAwMDAwMCJ9";
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(api.signRequest(payload));
+    }
+}
+BENCHMARK(BM_GeminiSign);
+
+// Full /api/orders response body: Order -> json conversion plus dump()
+static void BM_SerializeOrderHistory(benchmark::State& state) {
+    std::vector<Order> orders;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+        orders.push_back(Order{std::to_string(1700000000 + i), "AAPL", 10, i % 2 ? "buy" : "sell",
+                               189.5 + i % 13, 1895.0 + i % 13, "2024-01-01T00:00:00Z", "EXECUTED"});
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(orderHistoryToJson(orders).dump());
+    }
+    state.SetItemsProcessed(static_cast<int64_t>(state.iterations()) * state.range(0));
+}
+BENCHMARK(BM_SerializeOrderHistory)->Arg(100)->Arg(10000);
+
+static void BM_PositionEngineOnFill(benchmark::State& state) {
+    PositionEngine engine;
+    const char* symbols[] = {"BTC-USD", "ETH-USD", "SOL-USD", "AAPL"};
+    const char* venues[] = {"coinbase", "kraken", "gemini", "internal"};
+    std::size_t i = 0;
+    for (auto _ : state) {
+        engine.onFill(symbols[i & 3], venues[(i >> 2) & 3], (i & 1) ? "buy" : "sell", 1.0, 100.0 + (i % 17));
+        ++i;
+    }
+}
+BENCHMARK(BM_PositionEngineOnFill);
+
+static void BM_PositionEnginePnl(benchmark::State& state) {
+    PositionEngine engine;
+    for (int i = 0; i < 1000; ++i) engine.onFill("SYM" + std::to_string(i), "coinbase", "buy", 1.0, 100.0);
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(engine.pnl().dump());
+    }
+}
+BENCHMARK(BM_PositionEnginePnl);
+
+static void BM_ArbitrageOnTopOfBook(benchmark::State& state) {
+    ArbitrageMonitor monitor;
+    auto events = monitor.subscribe(1 << 16);
+    const Venue venues[] = {Venue::Coinbase, Venue::Kraken, Venue::Gemini};
+    std::size_t i = 0;
+    ArbitrageEvent ev;
+    for (auto _ : state) {
+        // Oscillate prices so legs keep crossing and uncrossing
+        double shift = (i % 8) * 0.5;
+        monitor.onTopOfBook("BTC-USD", venues[i % 3], 100.0 + shift, 1.0, 101.0 + shift, 1.0);
+        while (events->tryPop(ev)) {}
+        ++i;
+    }
+}
+BENCHMARK(BM_ArbitrageOnTopOfBook);
+
+static void BM_SpscRingPushPop(benchmark::State& state) {
+    SpscRing<ArbitrageEvent> ring(1024);
+    ArbitrageEvent ev{};
+    for (auto _ : state) {
+        ring.tryPush(ev);
+        ring.tryPop(ev);
+    }
+}
+BENCHMARK(BM_SpscRingPushPop);
+
+BENCHMARK_MAIN();
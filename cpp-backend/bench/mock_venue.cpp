@@ -0,0 +1,169 @@
+#include <crow.h>
+#include <nlohmann/json.hpp>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+
+using json = nlohmann::json;
+
+// Local stand-in for Coinbase, Kraken, Gemini and the price feed, so stock_server can be
+// load tested without touching real venues. Point stock_server at it with:
+//   COINBASE_API_URL=http://127.0.0.1:<port> KRAKEN_API_URL=... GEMINI_API_URL=... PRICE_API_URL=...
+//
+// Usage: mock_venue [port=3100] [latency_us=0]
+
+std::atomic<long> orderSeq{0};
+int latencyUs = 0;
+
+// Optional artificial venue latency
+void simulateLatency() {
+    if (latencyUs > 0) std::this_thread::sleep_for(std::chrono::microseconds(latencyUs));
+}
+
+// Deterministic books around a per-venue mid so the router has a stable best venue.
+// Each venue gets its real response shape so the per-venue parsers are exercised.
+
+// Coinbase level 2: {"bids": [["price", "size", num_orders], ...], "asks": ...}
+json makeCoinbaseBook(double mid, int levels) {
+    json book = {{"sequence", 1}, {"bids", json::array()}, {"asks", json::array()}};
+    for (int i = 0; i < levels; ++i) {
+        book["bids"].push_back({std::to_string(mid - 0.5 * (i + 1)), std::to_string(1.0 + i), 1});
+        book["asks"].push_back({std::to_string(mid + 0.5 * (i + 1)), std::to_string(1.0 + i), 1});
+    }
+    return book;
+}
+
+// Kraken: {"error": [], "result": {"XXBTZUSD": {"bids": [["price", "volume", ts], ...], "asks": ...}}}
+json makeKrakenBook(const std::string& pair, double mid, int levels) {
+    json side = {{"bids", json::array()}, {"asks", json::array()}};
+    for (int i = 0; i < levels; ++i) {
+        side["bids"].push_back({std::to_string(mid - 0.5 * (i + 1)), std::to_string(1.0 + i), 1700000000});
+        side["asks"].push_back({std::to_string(mid + 0.5 * (i + 1)), std::to_string(1.0 + i), 1700000000});
+    }
+    json book = {{"error", json::array()}};
+    book["result"][pair] = side;
+    return book;
+}
+
+// Gemini: {"bids": [{"price", "amount", "timestamp"}, ...], "asks": ...}
+json makeGeminiBook(double mid, int levels) {
+    json book = {{"bids", json::array()}, {"asks", json::array()}};
+    for (int i = 0; i < levels; ++i) {
+        book["bids"].push_back({{"price", std::to_string(mid - 0.5 * (i + 1))}, {"amount", std::to_string(1.0 + i)}, {"timestamp", "1700000000"}});
+        book["asks"].push_back({{"price", std::to_string(mid + 0.5 * (i + 1))}, {"amount", std::to_string(1.0 + i)}, {"timestamp", "1700000000"}});
+    }
+    return book;
+}
+
+// Kraken posts form fields as key="value"; pull one out of the body
+std::string formField(const std::string& body, const std::string& key) {
+    std::size_t pos = body.find(key + "=");
+    if (pos == std::string::npos) return "";
+    pos += key.size() + 1;
+    std::size_t end = body.find('&', pos);
+    std::string value = body.substr(pos, end == std::string::npos ? std::string::npos : end - pos);
+    value.erase(std::remove(value.begin(), value.end(), '"'), value.end());
+    return value;
+}
+
+// Kraken answers with its own name for the pair, e.g. XBTUSD -> XXBTZUSD
+std::string krakenResultKey(const std::string& pair) {
+    return pair == "XBTUSD" ? "XXBTZUSD" : pair;
+}
+
+int main(int argc, char* argv[]) {
+    int port = argc > 1 ? std::atoi(argv[1]) : 3100;
+    latencyUs = argc > 2 ? std::atoi(argv[2]) : 0;
+
+    crow::SimpleApp app;
+    app.loglevel(crow::LogLevel::Warning);
+
+    // Coinbase
+    CROW_ROUTE(app, "/products/<string>/book")
+        .methods("GET"_method)
+        ([](const std::string&) {
+            simulateLatency();
+            return crow::response(makeCoinbaseBook(50000.0, 50).dump());
+        });
+    CROW_ROUTE(app, "/orders")
+        .methods("POST"_method)
+        ([](const crow::request& req) {
+            simulateLatency();
+            json body = json::parse(req.body, nullptr, false);
+            json order = {
+                {"id", "coinbase-" + std::to_string(++orderSeq)},
+                {"product_id", body.value("product_id", "")},
+                {"side", body.value("side", "")},
+                {"type", "market"},
+                {"status", "pending"},
+                {"settled", false}
+            };
+            return crow::response(order.dump());
+        });
+
+    // Kraken (every call is a POST)
+    CROW_ROUTE(app, "/0/public/Depth")
+        .methods("POST"_method)
+        ([](const crow::request& req) {
+            simulateLatency();
+            return crow::response(makeKrakenBook(krakenResultKey(formField(req.body, "pair")), 50001.0, 50).dump());
+        });
+    CROW_ROUTE(app, "/0/private/AddOrder")
+        .methods("POST"_method)
+        ([](const crow::request& req) {
+            simulateLatency();
+            std::string descr = formField(req.body, "type") + " " + formField(req.body, "volume") + " " +
+                                formField(req.body, "pair") + " @ market";
+            json order = {{"error", json::array()}};
+            order["result"]["descr"]["order"] = descr;
+            order["result"]["txid"] = {"KRAKEN-" + std::to_string(++orderSeq)};
+            return crow::response(order.dump());
+        });
+
+    // Gemini (every call is a POST)
+    CROW_ROUTE(app, "/v1/book/<string>")
+        .methods("GET"_method, "POST"_method)
+        ([](const std::string&) {
+            simulateLatency();
+            return crow::response(makeGeminiBook(49999.0, 50).dump());
+        });
+    CROW_ROUTE(app, "/v1/order/new")
+        .methods("POST"_method)
+        ([](const crow::request& req) {
+            simulateLatency();
+            // The order travels both as the body and base64-encoded in X-GEMINI-PAYLOAD; fill it in full
+            json body = json::parse(req.body, nullptr, false);
+            json order = {
+                {"order_id", std::to_string(++orderSeq)},
+                {"symbol", body.value("symbol", "")},
+                {"side", body.value("side", "")},
+                {"type", body.value("type", "")},
+                {"is_live", false},
+                {"is_cancelled", false},
+                {"executed_amount", body.value("amount", "0")}
+            };
+            return crow::response(order.dump());
+        });
+
+    // Price feed, in the Yahoo Finance chart format getCurrentPrice/getHistoricalData expect
+    CROW_ROUTE(app, "/v8/finance/chart/<string>")
+        .methods("GET"_method)
+        ([](const std::string&) {
+            simulateLatency();
+            json result;
+            result["meta"]["regularMarketPrice"] = 189.5;
+            result["timestamp"] = {1700000000, 1700086400};
+            result["indicators"]["quote"][0] = {
+                {"open", {188.0, 189.0}}, {"high", {190.0, 191.0}}, {"low", {187.0, 188.0}}, {"close", {189.0, 189.5}}
+            };
+            json response;
+            response["chart"]["result"][0] = result;
+            return crow::response(response.dump());
+        });
+
+    app.port(port).multithreaded().run();
+    return 0;
+}
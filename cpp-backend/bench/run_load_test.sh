@@ -0,0 +1,63 @@
+#!/usr/bin/env bash
+# Runs stock_server against mock_venue and drives it with load_generator.
+# Usage: bench/run_load_test.sh <build_dir> [label] [extra load_generator args...]
+# Writes <build_dir>/load_<endpoint>_<mode>.json for each scenario.
+# Every scenario gets fresh mock_venue and stock_server processes, seeded with SEED_ORDERS
+# orders, so no scenario inherits the order history or state left by the one before it.
+set -euo pipefail
+
+BUILD_DIR=${1:?usage: run_load_test.sh <build_dir> [label] [load_generator args...]}
+LABEL=${2:-$(git rev-parse --short HEAD 2>/dev/null || echo local)}
+shift $(( $# > 1 ? 2 : 1 ))
+
+MOCK_PORT=${MOCK_PORT:-3100}
+SERVER_PORT=3000
+MOCK_URL="http://127.0.0.1:${MOCK_PORT}"
+SEED_ORDERS=${SEED_ORDERS:-1000}
+MOCK_PID=
+SERVER_PID=
+
+# Block until a local port accepts connections; fail if its process dies or READY_TIMEOUT (s) passes
+wait_for_port() {
+    local port=$1 pid=$2
+    local deadline=$(( SECONDS + ${READY_TIMEOUT:-30} ))
+    until (exec 3<>"/dev/tcp/127.0.0.1/${port}") 2>/dev/null; do
+        if ! kill -0 "${pid}" 2>/dev/null; then
+            echo "process for port ${port} exited before accepting connections" >&2
+            exit 1
+        fi
+        if (( SECONDS >= deadline )); then
+            echo "timed out waiting for port ${port}" >&2
+            exit 1
+        fi
+        sleep 0.1
+    done
+}
+
+start_servers() {
+    "${BUILD_DIR}/mock_venue" "${MOCK_PORT}" "${MOCK_LATENCY_US:-0}" &
+    MOCK_PID=$!
+    COINBASE_API_URL=${MOCK_URL} KRAKEN_API_URL=${MOCK_URL} GEMINI_API_URL=${MOCK_URL} PRICE_API_URL=${MOCK_URL} \
+        "${BUILD_DIR}/stock_server" &
+    SERVER_PID=$!
+    wait_for_port "${MOCK_PORT}" "${MOCK_PID}"
+    wait_for_port "${SERVER_PORT}" "${SERVER_PID}"
+}
+
+# Stop both servers and wait for them, so the next scenario can bind the same ports
+stop_servers() {
+    kill ${SERVER_PID} ${MOCK_PID} 2>/dev/null || true
+    wait ${SERVER_PID} ${MOCK_PID} 2>/dev/null || true
+    MOCK_PID=
+    SERVER_PID=
+}
+trap stop_servers EXIT
+
+for endpoint in order orders trade price mix; do
+    for mode in closed open; do
+        start_servers
+        "${BUILD_DIR}/load_generator" --port "${SERVER_PORT}" --endpoint "${endpoint}" --mode "${mode}" \
+            --seed-orders "${SEED_ORDERS}" --label "${LABEL}" --out "${BUILD_DIR}/load_${endpoint}_${mode}.json" "$@"
+        stop_servers
+    done
+done
@@ -0,0 +1,111 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "spsc_ring.h"
+#include "timing.h"
+#include "venue.h"
+
+// Fixed-size event published to subscribers when a cross-venue spread changes state
+struct ArbitrageEvent {
+    enum class Type : std::uint8_t { Locked, Crossed, Closed };
+
+    Type type;
+    char pair[16];
+    Venue buy_venue;      // venue whose ask we lift
+    Venue sell_venue;     // venue whose bid we hit
+    double ask;
+    double bid;
+    double depth;         // min(ask size, bid size)
+    double net_edge_bps;  // spread after taker fees on both legs, in bps of the ask
+    std::int64_t duration_ns;   // only set on Closed
+    std::int64_t timestamp_ns;  // steady clock
+};
+
+class ArbitrageMonitor {
+public:
+    using Subscription = std::shared_ptr<SpscRing<ArbitrageEvent>>;
+
+    ArbitrageMonitor();
+    ~ArbitrageMonitor();
+
+    // Apply a top-of-book change for one venue; re-evaluates only the venue pairs it touches.
+    // timestamp_ns is when the quote was observed (steady clock); 0 means now.
+    void onTopOfBook(const std::string& pair, Venue venue, double bid, double bid_size, double ask, double ask_size,
+                     std::int64_t timestamp_ns = 0);
+
+    // Taker fee for a venue in basis points
+    void setTakerFee(Venue venue, double bps);
+
+    // Quotes older than this are ignored when evaluating a leg
+    void setMaxQuoteAge(std::int64_t max_age_ns);
+
+    static const char* typeName(ArbitrageEvent::Type type);
+
+    // Register a subscriber queue; events are dropped (and counted) when it is full
+    Subscription subscribe(std::size_t capacity = 1024);
+
+    // Current signals and rolling statistics for every pair
+    nlohmann::json snapshot() const;
+
+private:
+    static constexpr std::size_t kLegs = kVenueCount * kVenueCount;
+
+    struct Quote {
+        double bid = 0.0;
+        double bid_size = 0.0;
+        double ask = 0.0;
+        double ask_size = 0.0;
+        std::int64_t updated_ns = 0;
+    };
+
+    struct Stats {
+        std::uint64_t opportunities = 0;
+        std::uint64_t profitable = 0;   // still positive after fees at some point while open
+        double total_duration_ns = 0.0;
+        double max_duration_ns = 0.0;
+        double ewma_duration_ns = 0.0;
+        double total_depth = 0.0;
+        double max_depth = 0.0;
+        double max_net_edge_bps = 0.0;
+    };
+
+    // One directional leg: buy on one venue, sell on another
+    struct Leg {
+        ArbitrageEvent::Type state = ArbitrageEvent::Type::Closed;
+        double net_edge_bps = 0.0;
+        std::int64_t opened_ns = 0;
+        double peak_depth = 0.0;
+        double peak_net_edge_bps = 0.0;
+        Stats stats;
+    };
+
+    struct PairState {
+        std::string pair;
+        std::array<Quote, kVenueCount> quotes;
+        std::array<Leg, kLegs> legs;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::size_t> index_;
+    std::vector<PairState> pairs_;
+    std::array<double, kVenueCount> fee_bps_;
+    std::int64_t max_quote_age_ns_;
+    std::vector<Subscription> subscribers_;
+    std::uint64_t updates_ = 0;
+    std::uint64_t events_published_ = 0;
+    std::uint64_t events_dropped_ = 0;
+    double max_detect_ns_ = 0.0;
+    double ewma_detect_ns_ = 0.0;
+
+    std::size_t slotFor(const std::string& pair);
+    bool isFresh(const Quote& quote, std::int64_t now_ns) const;
+    void evaluateLeg(PairState& ps, Venue buy, Venue sell, std::int64_t now_ns);
+    void publish(const PairState& ps, ArbitrageEvent::Type type, Venue buy, Venue sell, double depth, double net_edge_bps, std::int64_t duration_ns, std::int64_t now_ns);
+};
@@ -1,23 +1,34 @@
 #pragma once
+#include <memory>
 #include <string>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
+#include "http_request.h"
 
 class CoinbaseAPI {
 public:
-    CoinbaseAPI(const std::string& api_key, const std::string& api_secret, const std::string& passphrase);
+    // api_url can point at a mock venue for load testing
+    CoinbaseAPI(const std::string& api_key, const std::string& api_secret, const std::string& passphrase, const std::string& api_url = "https://api.exchange.coinbase.com");
     ~CoinbaseAPI();
 
     // Place a market order (buy/sell)
     nlohmann::json placeOrder(const std::string& side, const std::string& product_id, double size);
 
+    // Same order, signed but not sent, for callers that drive many transfers at once
+    std::unique_ptr<HttpRequest> prepareOrder(const std::string& side, const std::string& product_id, double size);
+
+    // Request signature as sent to the venue
+    std::string signRequest(const std::string& method, const std::string& request_path, const std::string& body, const std::string& timestamp) const;
+
+    // Signed request to the venue; also used by OrderBook for market data
+    nlohmann::json sendRequest(const std::string& method, const std::string& endpoint, const nlohmann::json& body = nullptr);
+
+    // Signed request without sending it
+    std::unique_ptr<HttpRequest> prepareRequest(const std::string& method, const std::string& endpoint, const nlohmann::json& body = nullptr);
+
 private:
     std::string api_key_;
     std::string api_secret_;
     std::string passphrase_;
-    std::string api_url_ = "https://api.exchange.coinbase.com";
-
-    std::string signRequest(const std::string& method, const std::string& request_path, const std::string& body, const std::string& timestamp) const;
-    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
-    nlohmann::json sendRequest(const std::string& method, const std::string& endpoint, const nlohmann::json& body = nullptr);
+    std::string api_url_;
 }; 
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+#include <string>
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+
+// A single prepared venue call. Owns the curl easy handle together with its headers,
+// request body and response buffer, so it can either be performed in place or added
+// to a curl multi handle and driven alongside other transfers.
+class HttpRequest {
+public:
+    // Takes ownership of headers; the body is sent as POST fields when post is true
+    HttpRequest(const std::string& url, curl_slist* headers, std::string body, bool post);
+    ~HttpRequest();
+
+    HttpRequest(const HttpRequest&) = delete;
+    HttpRequest& operator=(const HttpRequest&) = delete;
+
+    CURL* handle() const { return handle_; }
+
+    // Abort the transfer after this many milliseconds (0 = no limit)
+    void setTimeout(long timeout_ms);
+
+    // Blocking transfer on the calling thread
+    nlohmann::json perform();
+
+    // Parsed response of a finished transfer; {"error": ...} when it failed
+    nlohmann::json result(CURLcode code) const;
+
+private:
+    CURL* handle_;
+    curl_slist* headers_;
+    std::string body_;
+    std::string response_;
+
+    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
+};
@@ -1,22 +1,33 @@
 #pragma once
+#include <memory>
 #include <string>
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
+#include "http_request.h"
 
 class KrakenAPI {
 public:
-    KrakenAPI(const std::string& api_key, const std::string& api_secret);
+    // api_url can point at a mock venue for load testing
+    KrakenAPI(const std::string& api_key, const std::string& api_secret, const std::string& api_url = "https://api.kraken.com");
     ~KrakenAPI();
 
     // Place a market order (buy/sell)
     nlohmann::json placeOrder(const std::string& pair, const std::string& type, const std::string& ordertype, double volume);
 
-private:
-    std::string api_key_;
-    std::string api_secret_;
-    std::string api_url_ = "https://api.kraken.com";
+    // Same order, signed but not sent, for callers that drive many transfers at once
+    std::unique_ptr<HttpRequest> prepareOrder(const std::string& pair, const std::string& type, const std::string& ordertype, double volume);
 
+    // Request signature as sent to the venue
     std::string signRequest(const std::string& path, const std::string& nonce, const std::string& postdata) const;
-    static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
+
+    // Signed request to the venue; also used by OrderBook for market data
     nlohmann::json sendRequest(const std::string& endpoint, const nlohmann::json& body);
+
+    // Signed request without sending it
+    std::unique_ptr<HttpRequest> prepareRequest(const std::string& endpoint, const nlohmann::json& body);
+
+private:
+    std::string api_key_;
+    std::string api_secret_;
+    std::string api_url_;
 }; 
\ No newline at end of file
@@ -2,10 +2,20 @@
 #include <string>
 #include <vector>
 #include <map>
+#include <memory>
 #include <nlohmann/json.hpp>
 #include "coinbase_api.h"
 #include "kraken_api.h"
 #include "gemini_api.h"
+#include "venue.h"
+
+// Best level of a single venue book
+struct TopOfBook {
+    double bid = 0.0;
+    double bid_size = 0.0;
+    double ask = 0.0;
+    double ask_size = 0.0;
+};
 
 class OrderBook {
 public:
@@ -15,19 +25,32 @@ public:
     // Fetch and build the consolidated order book for the top 10 pairs
     nlohmann::json buildConsolidatedOrderBook();
 
-private:
-    CoinbaseAPI* coinbase_;
-    KrakenAPI* kraken_;
-    GeminiAPI* gemini_;
+    // Fetch the raw order book for a pair from one venue
+    nlohmann::json fetchVenueOrderBook(Venue venue, const std::string& pair);
+
+    // Same request, prepared but not sent; nullptr for a venue without a book
+    std::unique_ptr<HttpRequest> prepareVenueOrderBook(Venue venue, const std::string& pair);
+
+    // Extract the best bid/ask from a venue's raw book; zeros where a side is missing or malformed
+    static TopOfBook parseTopOfBook(Venue venue, const nlohmann::json& book);
+
+    // Convert a venue's raw book to the [["price","size"], ...] shape mergeOrderBooks expects,
+    // keeping each venue's decimal strings as sent
+    static nlohmann::json normalizeBook(Venue venue, const nlohmann::json& book);
+
+    // Merge normalized order books
+    nlohmann::json mergeOrderBooks(const std::string& pair, const std::vector<nlohmann::json>& books);
 
     // Helper to get top 10 pairs by volume (static for now, can be dynamic)
     std::vector<std::string> getTopPairs() const;
 
-    // Fetch order book from each exchange
-    nlohmann::json fetchCoinbaseOrderBook(const std::string& pair);
-    nlohmann::json fetchKrakenOrderBook(const std::string& pair);
-    nlohmann::json fetchGeminiOrderBook(const std::string& pair);
+private:
+    CoinbaseAPI* coinbase_;
+    KrakenAPI* kraken_;
+    GeminiAPI* gemini_;
 
-    // Merge order books
-    nlohmann::json mergeOrderBooks(const std::string& pair, const std::vector<nlohmann::json>& books);
+    // Order book request for each exchange
+    std::unique_ptr<HttpRequest> prepareCoinbaseOrderBook(const std::string& pair);
+    std::unique_ptr<HttpRequest> prepareKrakenOrderBook(const std::string& pair);
+    std::unique_ptr<HttpRequest> prepareGeminiOrderBook(const std::string& pair);
 }; 
\ No newline at end of file
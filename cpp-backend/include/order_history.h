@@ -0,0 +1,19 @@
+#pragma once
+#include <string>
+#include <vector>
+#include <nlohmann/json.hpp>
+
+// Structure to hold order data
+struct Order {
+    std::string id;
+    std::string symbol;
+    int quantity;
+    std::string type;
+    double price;
+    double total;
+    std::string timestamp;
+    std::string status;
+};
+
+// Order history in the /api/orders response shape
+nlohmann::json orderHistoryToJson(const std::vector<Order>& orders);
@@ -0,0 +1,195 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#include <curl/curl.h>
+#include <nlohmann/json.hpp>
+#include "spsc_ring.h"
+#include "timing.h"
+#include "http_request.h"
+#include "venue.h"
+#include "order_book.h"
+#include "coinbase_api.h"
+#include "kraken_api.h"
+#include "gemini_api.h"
+#include "arbitrage_monitor.h"
+#include "position_engine.h"
+
+// Core assignment per stage (-1 leaves the thread unpinned) and I/O limits
+struct PipelineConfig {
+    std::array<int, kVenueCount> io_cores;
+    int book_core = -1;
+    int router_core = -1;
+    std::size_t ring_capacity = 1024;
+    // Concurrent book fetches per venue I/O thread; orders are never held back by this
+    std::size_t max_in_flight = 64;
+    // Any single venue call is abandoned after this long
+    long venue_timeout_ms = 10000;
+    // A trade not sent to a venue by then fails without placing an order
+    long trade_timeout_ms = 30000;
+    // Book poll of every top pair on every venue, feeding the arbitrage monitor and marks; 0 (default)
+    // disables. Each venue is polled no faster than its public rate limit allows, whatever this is.
+    long poll_interval_ms = 0;
+
+    PipelineConfig() { io_cores.fill(-1); }
+
+    // Parse PIPELINE_CORES="coinbase,kraken,gemini,book,router" (e.g. "2,3,4,5,6")
+    // and PIPELINE_POLL_MS (book poll interval)
+    static PipelineConfig fromEnv();
+};
+
+// Fixed-size message carried by every ring in the pipeline
+struct PipelineMessage {
+    enum class Kind : std::uint8_t { Trade, FetchBook, BookSnapshot, TopOfBook, PlaceOrder, Execution };
+
+    Kind kind;
+    Venue venue;
+    std::uint64_t request_id;                    // 0 for book polls that belong to no trade
+    char pair[16];
+    char side[8];
+    double quantity;
+    double price;
+    TopOfBook top;
+    nlohmann::json* payload;                     // ownership passes to the receiving stage
+    std::promise<nlohmann::json>* reply;         // Trade only; completed by the router
+    std::int64_t deadline_ns;                    // Trade only; steady clock
+    std::int64_t enqueued_ns;
+};
+
+// What a venue's order response says about the order
+struct ExecutionReport {
+    bool accepted = false;
+    double filled_quantity = 0.0;   // quantity to book as a fill
+    std::string error;              // venue's reason when not accepted
+};
+
+// Staged execution pipeline: per-venue I/O threads -> book builder -> router, all
+// connected by SPSC rings. HTTP handlers only enqueue a request and await its future.
+// Each I/O thread drives its venue calls through a curl multi handle, so many requests
+// are in flight at once and an order never waits for a book fetch to finish.
+class Pipeline {
+public:
+    Pipeline(const PipelineConfig& config, CoinbaseAPI* coinbase, KrakenAPI* kraken, GeminiAPI* gemini,
+             ArbitrageMonitor* monitor, PositionEngine* positions);
+    ~Pipeline();
+
+    void start();
+    void stop();
+
+    // Route a market order to the venue with the best top of book; resolves with the /api/trade response.
+    // side is matched case-insensitively; anything but buy/sell resolves with an error.
+    std::future<nlohmann::json> submitTrade(const std::string& pair, const std::string& side, double quantity);
+
+    // Longest a submitTrade future can take to resolve: the trade deadline plus one order call
+    std::chrono::milliseconds replyTimeout() const;
+
+    // Queue depths and per-stage service times
+    nlohmann::json metrics() const;
+
+    // Read a venue's order response. Books the executed amount when the venue reports
+    // one and the requested quantity when it only acknowledges the order.
+    static ExecutionReport parseExecution(Venue venue, const nlohmann::json& response, double quantity);
+
+private:
+    using Ring = SpscRing<PipelineMessage>;
+
+    struct StageStats {
+        int requested_core = -1;
+        std::atomic<int> core{-1};     // core actually pinned to, -1 if unpinned
+        std::atomic<std::uint64_t> processed{0};
+        std::atomic<double> ewma_service_ns{0.0};
+        std::atomic<double> max_service_ns{0.0};
+        std::atomic<double> ewma_queue_ns{0.0};
+    };
+
+    // A venue call started by an I/O thread
+    struct Transfer {
+        PipelineMessage msg;
+        std::unique_ptr<HttpRequest> request;
+        std::int64_t start_ns;
+    };
+
+    struct PendingTrade {
+        std::promise<nlohmann::json>* reply;
+        std::string pair;
+        std::string side;
+        double quantity;
+        std::int64_t deadline_ns;
+        bool ordered = false;       // PlaceOrder sent; from here the trade waits for the venue
+        std::array<TopOfBook, kVenueCount> quotes;
+        std::size_t received = 0;
+    };
+
+    PipelineConfig config_;
+    CoinbaseAPI* coinbase_;
+    KrakenAPI* kraken_;
+    GeminiAPI* gemini_;
+    ArbitrageMonitor* monitor_;
+    PositionEngine* positions_;
+    OrderBook books_;
+
+    // HTTP -> router; many Crow workers produce, so pushes are serialized by ingress_mutex_
+    Ring ingress_;
+    std::mutex ingress_mutex_;
+    // router -> io[venue] (orders and book fetches on separate rings, orders drained first),
+    // io[venue] -> book builder, io[venue] -> router
+    std::array<std::unique_ptr<Ring>, kVenueCount> to_io_orders_;
+    std::array<std::unique_ptr<Ring>, kVenueCount> to_io_books_;
+    std::array<std::unique_ptr<Ring>, kVenueCount> io_to_book_;
+    std::array<std::unique_ptr<Ring>, kVenueCount> io_to_router_;
+    // book builder -> router
+    Ring book_to_router_;
+
+    // One multi handle per I/O thread; the router wakes it after queueing work
+    std::array<CURLM*, kVenueCount> io_multi_{};
+    std::array<std::atomic<std::size_t>, kVenueCount> io_in_flight_{};
+    // Poll fetches queued by the router whose snapshot the book builder has not consumed yet
+    std::array<std::atomic<std::size_t>, kVenueCount> polls_outstanding_{};
+
+    std::array<StageStats, kVenueCount> io_stats_;
+    StageStats book_stats_;
+    StageStats router_stats_;
+
+    std::atomic<bool> running_{false};
+    std::atomic<std::uint64_t> next_request_id_{1};
+    std::atomic<std::size_t> pending_count_{0};
+    std::vector<std::thread> threads_;
+
+    // Router-owned state
+    std::unordered_map<std::uint64_t, PendingTrade> pending_;
+    std::array<std::int64_t, kVenueCount> next_poll_ns_{};
+
+    void ioLoop(Venue venue);
+    void bookLoop();
+    void routerLoop();
+
+    void startTransfer(Venue venue, const PipelineMessage& msg, std::unordered_map<CURL*, Transfer>& in_flight);
+    void finishTransfer(Venue venue, Transfer& transfer, CURLcode code);
+    std::unique_ptr<HttpRequest> prepareOrder(Venue venue, const PipelineMessage& msg);
+    bool queueForIo(Ring& ring, Venue venue, const PipelineMessage& msg);
+
+    void pollBooks(std::int64_t now_ns);
+    void routeTrade(const PipelineMessage& msg);
+    void routeTopOfBook(const PipelineMessage& msg);
+    void routeExecution(PipelineMessage& msg);
+    void failTrade(std::uint64_t request_id, const std::string& error, bool timed_out = false);
+    void expireTrades(std::int64_t now_ns);
+
+    // Spins (then yields) until the message is accepted or the pipeline stops
+    bool pushBlocking(Ring& ring, const PipelineMessage& msg);
+    void drain(Ring& ring);
+
+    // Pin the calling thread; returns the core it now runs on, or -1 (logged) if it stays unpinned
+    static int pinToCore(int core, const char* stage);
+    static void recordService(StageStats& stats, const PipelineMessage& msg, std::int64_t start_ns);
+    static nlohmann::json statsToJson(const StageStats& stats);
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <array>
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <nlohmann/json.hpp>
+#include "venue.h"
+
+class PositionEngine {
+public:
+    PositionEngine();
+    ~PositionEngine();
+
+    // Apply a fill (side is "buy" or "sell", any case); updates the venue slot and the per-symbol
+    // aggregate. Returns false and changes nothing for a non-positive quantity/price or unknown side.
+    bool onFill(const std::string& symbol, const std::string& venue, const std::string& side, double quantity, double price);
+
+    // Mark an instrument to a new price and refresh its unrealized PnL
+    void onPrice(const std::string& symbol, double price);
+
+    // Snapshot of every instrument, O(number of instruments)
+    nlohmann::json positions() const;
+
+    // Position of a single instrument, O(1); null if the symbol has never traded
+    nlohmann::json position(const std::string& symbol) const;
+
+    // Portfolio-wide realized/unrealized PnL, O(1)
+    nlohmann::json pnl() const;
+
+private:
+    struct Slot {
+        double net = 0.0;
+        double avg_cost = 0.0;
+        double realized = 0.0;
+        double unrealized = 0.0;
+    };
+
+    struct Instrument {
+        std::string symbol;
+        double mark = 0.0;
+        Slot total;
+        std::array<Slot, kVenueCount> venues;
+    };
+
+    mutable std::mutex mutex_;
+    std::unordered_map<std::string, std::size_t> index_;
+    std::vector<Instrument> instruments_;
+    double total_realized_ = 0.0;
+    double total_unrealized_ = 0.0;
+    std::size_t fill_count_ = 0;
+
+    // Returns the slot index for a symbol, creating it on first sight
+    std::size_t slotFor(const std::string& symbol);
+
+    static void applyFill(Slot& slot, double signed_qty, double price);
+    static void markSlot(Slot& slot, double mark);
+    static nlohmann::json slotToJson(const Slot& slot);
+    static nlohmann::json instrumentToJson(const Instrument& inst);
+};
@@ -0,0 +1,60 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <vector>
+
+// Bounded lock-free single-producer/single-consumer ring buffer.
+// Capacity is rounded up to a power of two; pushes fail instead of blocking when full.
+template <typename T>
+class SpscRing {
+public:
+    explicit SpscRing(std::size_t capacity) {
+        std::size_t cap = 2;
+        while (cap < capacity) cap <<= 1;
+        buffer_.resize(cap);
+        mask_ = cap - 1;
+    }
+
+    SpscRing(const SpscRing&) = delete;
+    SpscRing& operator=(const SpscRing&) = delete;
+
+    // Producer side
+    bool tryPush(const T& item) {
+        std::size_t head = head_.load(std::memory_order_relaxed);
+        if (head - tail_cache_ > mask_) {
+            tail_cache_ = tail_.load(std::memory_order_acquire);
+            if (head - tail_cache_ > mask_) return false;
+        }
+        buffer_[head & mask_] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Consumer side
+    bool tryPop(T& item) {
+        std::size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail == head_cache_) {
+            head_cache_ = head_.load(std::memory_order_acquire);
+            if (tail == head_cache_) return false;
+        }
+        item = buffer_[tail & mask_];
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    // Approximate when called concurrently with push/pop
+    std::size_t size() const {
+        return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+    }
+
+    std::size_t capacity() const { return mask_ + 1; }
+
+private:
+    std::vector<T> buffer_;
+    std::size_t mask_ = 0;
+    // Producer and consumer indices live on separate cache lines to avoid false sharing
+    alignas(64) std::atomic<std::size_t> head_{0};
+    std::size_t tail_cache_ = 0;
+    alignas(64) std::atomic<std::size_t> tail_{0};
+    std::size_t head_cache_ = 0;
+};
@@ -0,0 +1,12 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// Steady-clock time in nanoseconds; quote ages, stage latencies and deadlines all use this clock
+inline std::int64_t steadyNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Weight of the newest sample in the rolling (EWMA) latency and duration averages
+constexpr double kEwmaAlpha = 0.1;
@@ -0,0 +1,38 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <string>
+
+// Venues the backend trades on. "internal" covers simulated fills from /api/order.
+enum class Venue : std::size_t { Internal = 0, Coinbase, Kraken, Gemini, Count };
+
+constexpr std::size_t kVenueCount = static_cast<std::size_t>(Venue::Count);
+
+inline Venue parseVenue(const std::string& venue) {
+    std::string v = venue;
+    std::transform(v.begin(), v.end(), v.begin(), ::tolower);
+    if (v == "coinbase") return Venue::Coinbase;
+    if (v == "kraken") return Venue::Kraken;
+    if (v == "gemini") return Venue::Gemini;
+    return Venue::Internal;
+}
+
+// True for the external exchanges, false for Internal and the Count sentinel
+inline bool isExchange(Venue venue) {
+    return venue != Venue::Internal && venue != Venue::Count;
+}
+
+inline const char* venueName(Venue venue) {
+    switch (venue) {
+        case Venue::Coinbase: return "coinbase";
+        case Venue::Kraken: return "kraken";
+        case Venue::Gemini: return "gemini";
+        default: return "internal";
+    }
+}
+
+// Lower-case a trade side in place; false unless it is "buy" or "sell" in any case
+inline bool normalizeSide(std::string& side) {
+    std::transform(side.begin(), side.end(), side.begin(), ::tolower);
+    return side == "buy" || side == "sell";
+}
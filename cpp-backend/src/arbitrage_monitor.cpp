@@ -0,0 +1,222 @@
+#include "arbitrage_monitor.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+// Default staleness bound: a few book polls
+constexpr std::int64_t kDefaultMaxQuoteAgeNs = 3000000000LL;
+}
+
+const char* ArbitrageMonitor::typeName(ArbitrageEvent::Type type) {
+    switch (type) {
+        case ArbitrageEvent::Type::Locked: return "locked";
+        case ArbitrageEvent::Type::Crossed: return "crossed";
+        default: return "closed";
+    }
+}
+
+ArbitrageMonitor::ArbitrageMonitor() : max_quote_age_ns_(kDefaultMaxQuoteAgeNs) {
+    // Default taker fees (bps); override with setTakerFee for negotiated tiers
+    fee_bps_.fill(0.0);
+    fee_bps_[static_cast<std::size_t>(Venue::Coinbase)] = 60.0;
+    fee_bps_[static_cast<std::size_t>(Venue::Kraken)] = 26.0;
+    fee_bps_[static_cast<std::size_t>(Venue::Gemini)] = 40.0;
+}
+
+ArbitrageMonitor::~ArbitrageMonitor() {}
+
+void ArbitrageMonitor::setTakerFee(Venue venue, double bps) {
+    if (!isExchange(venue)) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    fee_bps_[static_cast<std::size_t>(venue)] = bps;
+}
+
+void ArbitrageMonitor::setMaxQuoteAge(std::int64_t max_age_ns) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_quote_age_ns_ = max_age_ns;
+}
+
+bool ArbitrageMonitor::isFresh(const Quote& quote, std::int64_t now_ns) const {
+    return quote.updated_ns != 0 && now_ns - quote.updated_ns <= max_quote_age_ns_;
+}
+
+ArbitrageMonitor::Subscription ArbitrageMonitor::subscribe(std::size_t capacity) {
+    auto ring = std::make_shared<SpscRing<ArbitrageEvent>>(capacity);
+    std::lock_guard<std::mutex> lock(mutex_);
+    subscribers_.push_back(ring);
+    return ring;
+}
+
+std::size_t ArbitrageMonitor::slotFor(const std::string& pair) {
+    auto it = index_.find(pair);
+    if (it != index_.end()) return it->second;
+    std::size_t idx = pairs_.size();
+    pairs_.emplace_back();
+    pairs_.back().pair = pair;
+    index_.emplace(pair, idx);
+    return idx;
+}
+
+void ArbitrageMonitor::onTopOfBook(const std::string& pair, Venue venue, double bid, double bid_size, double ask, double ask_size,
+                                   std::int64_t timestamp_ns) {
+    if (!isExchange(venue)) return;
+    std::int64_t start_ns = steadyNowNs();
+    std::int64_t quote_ns = timestamp_ns ? timestamp_ns : start_ns;
+    std::lock_guard<std::mutex> lock(mutex_);
+    PairState& ps = pairs_[slotFor(pair)];
+    Quote& q = ps.quotes[static_cast<std::size_t>(venue)];
+    q.bid = bid;
+    q.bid_size = bid_size;
+    q.ask = ask;
+    q.ask_size = ask_size;
+    q.updated_ns = quote_ns;
+
+    // Only the legs that involve this venue can have changed
+    for (std::size_t i = 0; i < kVenueCount; ++i) {
+        Venue other = static_cast<Venue>(i);
+        if (other == venue || !isExchange(other)) continue;
+        evaluateLeg(ps, venue, other, quote_ns);
+        evaluateLeg(ps, other, venue, quote_ns);
+    }
+
+    ++updates_;
+    double detect_ns = static_cast<double>(steadyNowNs() - start_ns);
+    max_detect_ns_ = std::max(max_detect_ns_, detect_ns);
+    ewma_detect_ns_ += kEwmaAlpha * (detect_ns - ewma_detect_ns_);
+}
+
+void ArbitrageMonitor::evaluateLeg(PairState& ps, Venue buy, Venue sell, std::int64_t now_ns) {
+    const Quote& qb = ps.quotes[static_cast<std::size_t>(buy)];
+    const Quote& qs = ps.quotes[static_cast<std::size_t>(sell)];
+    Leg& leg = ps.legs[static_cast<std::size_t>(buy) * kVenueCount + static_cast<std::size_t>(sell)];
+
+    ArbitrageEvent::Type state = ArbitrageEvent::Type::Closed;
+    double net_edge_bps = 0.0;
+    double depth = 0.0;
+    // A stale quote on either side cannot form an opportunity
+    if (qb.ask > 0.0 && qs.bid > 0.0 && isFresh(qb, now_ns) && isFresh(qs, now_ns)) {
+        if (qs.bid > qb.ask) state = ArbitrageEvent::Type::Crossed;
+        else if (qs.bid == qb.ask) state = ArbitrageEvent::Type::Locked;
+        double proceeds = qs.bid * (1.0 - fee_bps_[static_cast<std::size_t>(sell)] / 1e4);
+        double cost = qb.ask * (1.0 + fee_bps_[static_cast<std::size_t>(buy)] / 1e4);
+        net_edge_bps = (proceeds - cost) / qb.ask * 1e4;
+        depth = std::min(qb.ask_size, qs.bid_size);
+    }
+    leg.net_edge_bps = net_edge_bps;
+
+    if (state != leg.state) {
+        ArbitrageEvent::Type prev = leg.state;
+        leg.state = state;
+        if (prev != ArbitrageEvent::Type::Closed && state == ArbitrageEvent::Type::Closed) {
+            publish(ps, ArbitrageEvent::Type::Closed, buy, sell, depth, net_edge_bps, now_ns - leg.opened_ns, now_ns);
+        }
+        if (prev == ArbitrageEvent::Type::Crossed) {
+            // Crossed episode finished: fold it into the rolling statistics
+            Stats& s = leg.stats;
+            double duration = static_cast<double>(now_ns - leg.opened_ns);
+            ++s.opportunities;
+            if (leg.peak_net_edge_bps > 0.0) ++s.profitable;
+            s.total_duration_ns += duration;
+            s.max_duration_ns = std::max(s.max_duration_ns, duration);
+            s.ewma_duration_ns = s.opportunities == 1 ? duration : s.ewma_duration_ns + kEwmaAlpha * (duration - s.ewma_duration_ns);
+            s.total_depth += leg.peak_depth;
+            s.max_depth = std::max(s.max_depth, leg.peak_depth);
+            s.max_net_edge_bps = std::max(s.max_net_edge_bps, leg.peak_net_edge_bps);
+        }
+        if (state != ArbitrageEvent::Type::Closed) {
+            leg.opened_ns = now_ns;
+            leg.peak_depth = 0.0;
+            leg.peak_net_edge_bps = net_edge_bps;
+            publish(ps, state, buy, sell, depth, net_edge_bps, 0, now_ns);
+        }
+    }
+    if (state == ArbitrageEvent::Type::Crossed) {
+        leg.peak_depth = std::max(leg.peak_depth, depth);
+        leg.peak_net_edge_bps = std::max(leg.peak_net_edge_bps, net_edge_bps);
+    }
+}
+
+void ArbitrageMonitor::publish(const PairState& ps, ArbitrageEvent::Type type, Venue buy, Venue sell, double depth, double net_edge_bps, std::int64_t duration_ns, std::int64_t now_ns) {
+    ArbitrageEvent ev;
+    ev.type = type;
+    std::memset(ev.pair, 0, sizeof(ev.pair));
+    std::strncpy(ev.pair, ps.pair.c_str(), sizeof(ev.pair) - 1);
+    ev.buy_venue = buy;
+    ev.sell_venue = sell;
+    ev.ask = ps.quotes[static_cast<std::size_t>(buy)].ask;
+    ev.bid = ps.quotes[static_cast<std::size_t>(sell)].bid;
+    ev.depth = depth;
+    ev.net_edge_bps = net_edge_bps;
+    ev.duration_ns = duration_ns;
+    ev.timestamp_ns = now_ns;
+    // Producers are serialized by mutex_, so each ring still sees a single producer
+    for (auto& sub : subscribers_) {
+        if (sub->tryPush(ev)) ++events_published_;
+        else ++events_dropped_;
+    }
+}
+
+nlohmann::json ArbitrageMonitor::snapshot() const {
+    // Copy the state under the lock and build the JSON after releasing it, so book
+    // updates are held up only for the copy
+    std::vector<PairState> pairs;
+    std::uint64_t updates, published, dropped;
+    std::int64_t max_quote_age_ns, now_ns;
+    double ewma_detect_ns, max_detect_ns;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pairs = pairs_;
+        updates = updates_;
+        published = events_published_;
+        dropped = events_dropped_;
+        max_quote_age_ns = max_quote_age_ns_;
+        ewma_detect_ns = ewma_detect_ns_;
+        max_detect_ns = max_detect_ns_;
+        now_ns = steadyNowNs();
+    }
+    nlohmann::json result;
+    result["updates"] = updates;
+    result["events_published"] = published;
+    result["events_dropped"] = dropped;
+    result["max_quote_age_ns"] = max_quote_age_ns;
+    result["detect_latency_ns"] = {{"ewma", ewma_detect_ns}, {"max", max_detect_ns}};
+    result["pairs"] = nlohmann::json::object();
+    for (const auto& ps : pairs) {
+        nlohmann::json item;
+        for (std::size_t i = 0; i < kVenueCount; ++i) {
+            const Quote& q = ps.quotes[i];
+            if (q.bid <= 0.0 && q.ask <= 0.0) continue;
+            item["quotes"][venueName(static_cast<Venue>(i))] = {
+                {"bid", q.bid}, {"bid_size", q.bid_size}, {"ask", q.ask}, {"ask_size", q.ask_size},
+                {"age_ns", now_ns - q.updated_ns}
+            };
+        }
+        item["legs"] = nlohmann::json::array();
+        for (std::size_t b = 0; b < kVenueCount; ++b) {
+            for (std::size_t s = 0; s < kVenueCount; ++s) {
+                if (b == s || !isExchange(static_cast<Venue>(b)) || !isExchange(static_cast<Venue>(s))) continue;
+                const Leg& leg = ps.legs[b * kVenueCount + s];
+                const Stats& st = leg.stats;
+                double n = st.opportunities ? static_cast<double>(st.opportunities) : 1.0;
+                item["legs"].push_back({
+                    {"buy", venueName(static_cast<Venue>(b))},
+                    {"sell", venueName(static_cast<Venue>(s))},
+                    {"state", typeName(leg.state)},
+                    {"net_edge_bps", leg.net_edge_bps},
+                    {"stats", {
+                        {"opportunities", st.opportunities},
+                        {"profitable", st.profitable},
+                        {"mean_duration_ns", st.total_duration_ns / n},
+                        {"ewma_duration_ns", st.ewma_duration_ns},
+                        {"max_duration_ns", st.max_duration_ns},
+                        {"mean_depth", st.total_depth / n},
+                        {"max_depth", st.max_depth},
+                        {"max_net_edge_bps", st.max_net_edge_bps}
+                    }}
+                });
+            }
+        }
+        result["pairs"][ps.pair] = item;
+    }
+    return result;
+}
@@ -5,8 +5,8 @@
 #include <iomanip>
 #include <ctime>
 
-CoinbaseAPI::CoinbaseAPI(const std::string& api_key, const std::string& api_secret, const std::string& passphrase)
-    : api_key_(api_key), api_secret_(api_secret), passphrase_(passphrase) {}
+CoinbaseAPI::CoinbaseAPI(const std::string& api_key, const std::string& api_secret, const std::string& passphrase, const std::string& api_url)
+    : api_key_(api_key), api_secret_(api_secret), passphrase_(passphrase), api_url_(api_url) {}
 
 CoinbaseAPI::~CoinbaseAPI() {}
 
@@ -22,14 +22,7 @@ std::string CoinbaseAPI::signRequest(const std::string& method, const std::strin
     return oss.str();
 }
 
-size_t CoinbaseAPI::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-    ((std::string*)userp)->append((char*)contents, size * nmemb);
-    return size * nmemb;
-}
-
-nlohmann::json CoinbaseAPI::sendRequest(const std::string& method, const std::string& endpoint, const nlohmann::json& body) {
-    CURL* curl = curl_easy_init();
-    std::string readBuffer;
+std::unique_ptr<HttpRequest> CoinbaseAPI::prepareRequest(const std::string& method, const std::string& endpoint, const nlohmann::json& body) {
     std::string url = api_url_ + endpoint;
     std::string body_str = body.is_null() ? "" : body.dump();
     std::string timestamp = std::to_string(std::time(nullptr));
@@ -42,32 +35,23 @@ nlohmann::json CoinbaseAPI::sendRequest(const std::string& method, const std::st
     headers = curl_slist_append(headers, ("CB-ACCESS-PASSPHRASE: " + passphrase_).c_str());
     headers = curl_slist_append(headers, "Content-Type: application/json");
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-    if (method == "POST") {
-        curl_easy_setopt(curl, CURLOPT_POSTFIELDS, body_str.c_str());
-    }
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
-    if (res != CURLE_OK) {
-        return nlohmann::json{{"error", curl_easy_strerror(res)}};
-    }
-    try {
-        return nlohmann::json::parse(readBuffer);
-    } catch (...) {
-        return nlohmann::json{{"error", "Failed to parse JSON"}};
-    }
+    return std::unique_ptr<HttpRequest>(new HttpRequest(url, headers, body_str, method == "POST"));
 }
 
-nlohmann::json CoinbaseAPI::placeOrder(const std::string& side, const std::string& product_id, double size) {
+nlohmann::json CoinbaseAPI::sendRequest(const std::string& method, const std::string& endpoint, const nlohmann::json& body) {
+    return prepareRequest(method, endpoint, body)->perform();
+}
+
+std::unique_ptr<HttpRequest> CoinbaseAPI::prepareOrder(const std::string& side, const std::string& product_id, double size) {
     nlohmann::json order = {
         {"type", "market"},
         {"side", side},
         {"product_id", product_id},
         {"size", size}
     };
-    return sendRequest("POST", "/orders", order);
+    return prepareRequest("POST", "/orders", order);
+}
+
+nlohmann::json CoinbaseAPI::placeOrder(const std::string& side, const std::string& product_id, double size) {
+    return prepareOrder(side, product_id, size)->perform();
 } 
\ No newline at end of file
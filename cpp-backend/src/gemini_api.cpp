@@ -7,10 +7,9 @@
 #include <ctime>
 #include <vector>
 #include <cstring>
-#include <base64.h> // If not available, implement base64 encoding inline
 
-GeminiAPI::GeminiAPI(const std::string& api_key, const std::string& api_secret)
-    : api_key_(api_key), api_secret_(api_secret) {}
+GeminiAPI::GeminiAPI(const std::string& api_key, const std::string& api_secret, const std::string& api_url)
+    : api_key_(api_key), api_secret_(api_secret), api_url_(api_url) {}
 
 GeminiAPI::~GeminiAPI() {}
 
@@ -36,14 +35,7 @@ std::string GeminiAPI::signRequest(const std::string& payload) const {
     return base64_encode(digest, 48); // SHA384 digest is 48 bytes
 }
 
-size_t GeminiAPI::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-    ((std::string*)userp)->append((char*)contents, size * nmemb);
-    return size * nmemb;
-}
-
-nlohmann::json GeminiAPI::sendRequest(const std::string& endpoint, const nlohmann::json& body) {
-    CURL* curl = curl_easy_init();
-    std::string readBuffer;
+std::unique_ptr<HttpRequest> GeminiAPI::prepareRequest(const std::string& endpoint, const nlohmann::json& body) {
     std::string url = api_url_ + endpoint;
     std::string payload = body.dump();
     std::string b64_payload = base64_encode(reinterpret_cast<const unsigned char*>(payload.c_str()), payload.length());
@@ -55,25 +47,14 @@ nlohmann::json GeminiAPI::sendRequest(const std::string& endpoint, const nlohman
     headers = curl_slist_append(headers, ("X-GEMINI-SIGNATURE: " + signature).c_str());
     headers = curl_slist_append(headers, "Content-Type: application/json");
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, payload.c_str());
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
-    if (res != CURLE_OK) {
-        return nlohmann::json{{"error", curl_easy_strerror(res)}};
-    }
-    try {
-        return nlohmann::json::parse(readBuffer);
-    } catch (...) {
-        return nlohmann::json{{"error", "Failed to parse JSON"}};
-    }
+    return std::unique_ptr<HttpRequest>(new HttpRequest(url, headers, payload, true));
 }
 
-nlohmann::json GeminiAPI::placeOrder(const std::string& symbol, const std::string& side, double amount) {
+nlohmann::json GeminiAPI::sendRequest(const std::string& endpoint, const nlohmann::json& body) {
+    return prepareRequest(endpoint, body)->perform();
+}
+
+std::unique_ptr<HttpRequest> GeminiAPI::prepareOrder(const std::string& symbol, const std::string& side, double amount) {
     std::string endpoint = "/v1/order/new";
     nlohmann::json order = {
         {"request", endpoint},
@@ -83,5 +64,9 @@ nlohmann::json GeminiAPI::placeOrder(const std::string& symbol, const std::strin
         {"side", side},
         {"type", "exchange market"}
     };
-    return sendRequest(endpoint, order);
-} 
\ No newline at end of file
+    return prepareRequest(endpoint, order);
+}
+
+nlohmann::json GeminiAPI::placeOrder(const std::string& symbol, const std::string& side, double amount) {
+    return prepareOrder(symbol, side, amount)->perform();
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "http_request.h"
+
+HttpRequest::HttpRequest(const std::string& url, curl_slist* headers, std::string body, bool post)
+    : handle_(curl_easy_init()), headers_(headers), body_(std::move(body)) {
+    curl_easy_setopt(handle_, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(handle_, CURLOPT_HTTPHEADER, headers_);
+    curl_easy_setopt(handle_, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(handle_, CURLOPT_WRITEDATA, &response_);
+    // Signals cannot be used for timeouts off the main thread
+    curl_easy_setopt(handle_, CURLOPT_NOSIGNAL, 1L);
+    if (post) {
+        curl_easy_setopt(handle_, CURLOPT_POSTFIELDS, body_.c_str());
+    }
+}
+
+HttpRequest::~HttpRequest() {
+    curl_easy_cleanup(handle_);
+    curl_slist_free_all(headers_);
+}
+
+size_t HttpRequest::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    ((std::string*)userp)->append((char*)contents, size * nmemb);
+    return size * nmemb;
+}
+
+void HttpRequest::setTimeout(long timeout_ms) {
+    curl_easy_setopt(handle_, CURLOPT_TIMEOUT_MS, timeout_ms);
+}
+
+nlohmann::json HttpRequest::perform() {
+    return result(curl_easy_perform(handle_));
+}
+
+nlohmann::json HttpRequest::result(CURLcode code) const {
+    if (code != CURLE_OK) {
+        return nlohmann::json{{"error", curl_easy_strerror(code)}};
+    }
+    try {
+        return nlohmann::json::parse(response_);
+    } catch (...) {
+        return nlohmann::json{{"error", "Failed to parse JSON"}};
+    }
+}
@@ -9,8 +9,8 @@
 #include <vector>
 #include <cstring>
 
-KrakenAPI::KrakenAPI(const std::string& api_key, const std::string& api_secret)
-    : api_key_(api_key), api_secret_(api_secret) {}
+KrakenAPI::KrakenAPI(const std::string& api_key, const std::string& api_secret, const std::string& api_url)
+    : api_key_(api_key), api_secret_(api_secret), api_url_(api_url) {}
 
 KrakenAPI::~KrakenAPI() {}
 
@@ -41,14 +41,7 @@ std::string KrakenAPI::signRequest(const std::string& path, const std::string& n
     return std::string((char*)digest, SHA512_DIGEST_LENGTH);
 }
 
-size_t KrakenAPI::writeCallback(void* contents, size_t size, size_t nmemb, void* userp) {
-    ((std::string*)userp)->append((char*)contents, size * nmemb);
-    return size * nmemb;
-}
-
-nlohmann::json KrakenAPI::sendRequest(const std::string& endpoint, const nlohmann::json& body) {
-    CURL* curl = curl_easy_init();
-    std::string readBuffer;
+std::unique_ptr<HttpRequest> KrakenAPI::prepareRequest(const std::string& endpoint, const nlohmann::json& body) {
     std::string url = api_url_ + endpoint;
     std::string nonce = std::to_string(std::time(nullptr));
     std::string postdata = "nonce=" + nonce;
@@ -62,30 +55,23 @@ nlohmann::json KrakenAPI::sendRequest(const std::string& endpoint, const nlohman
     headers = curl_slist_append(headers, ("API-Sign: " + signature).c_str());
     headers = curl_slist_append(headers, "Content-Type: application/x-www-form-urlencoded");
 
-    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-    curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
-    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
-    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &readBuffer);
-    curl_easy_setopt(curl, CURLOPT_POSTFIELDS, postdata.c_str());
-    CURLcode res = curl_easy_perform(curl);
-    curl_easy_cleanup(curl);
-    curl_slist_free_all(headers);
-    if (res != CURLE_OK) {
-        return nlohmann::json{{"error", curl_easy_strerror(res)}};
-    }
-    try {
-        return nlohmann::json::parse(readBuffer);
-    } catch (...) {
-        return nlohmann::json{{"error", "Failed to parse JSON"}};
-    }
+    return std::unique_ptr<HttpRequest>(new HttpRequest(url, headers, postdata, true));
 }
 
-nlohmann::json KrakenAPI::placeOrder(const std::string& pair, const std::string& type, const std::string& ordertype, double volume) {
+nlohmann::json KrakenAPI::sendRequest(const std::string& endpoint, const nlohmann::json& body) {
+    return prepareRequest(endpoint, body)->perform();
+}
+
+std::unique_ptr<HttpRequest> KrakenAPI::prepareOrder(const std::string& pair, const std::string& type, const std::string& ordertype, double volume) {
     nlohmann::json order = {
         {"pair", pair},
         {"type", type},
         {"ordertype", ordertype},
         {"volume", volume}
     };
-    return sendRequest("/0/private/AddOrder", order);
+    return prepareRequest("/0/private/AddOrder", order);
+}
+
+nlohmann::json KrakenAPI::placeOrder(const std::string& pair, const std::string& type, const std::string& ordertype, double volume) {
+    return prepareOrder(pair, type, ordertype, volume)->perform();
 } 
\ No newline at end of file
@@ -1,4 +1,5 @@
 #include <crow.h>
+#include "crow/middlewares/cors.h"
 #include <curl/curl.h>
 #include <nlohmann/json.hpp>
 #include <string>
@@ -7,10 +8,18 @@
 #include <chrono>
 #include <iomanip>
 #include <sstream>
+#include <mutex>
+#include <future>
+#include <cstdlib>
+#include <iostream>
 #include "order_book.h"
+#include "order_history.h"
 #include "coinbase_api.h"
 #include "kraken_api.h"
 #include "gemini_api.h"
+#include "position_engine.h"
+#include "arbitrage_monitor.h"
+#include "pipeline.h"
 
 using json = nlohmann::json;
 
@@ -23,21 +32,21 @@ struct StockData {
     double close;
 };
 
-// Structure to hold order data
-struct Order {
-    std::string id;
-    std::string symbol;
-    int quantity;
-    std::string type;
-    double price;
-    double total;
-    std::string timestamp;
-    std::string status;
-};
-
 // Global variables
 std::vector<Order> orderBook;
 std::map<std::string, double> lastPrices;
+// Crow serves requests on several threads; guards orderBook and lastPrices
+std::mutex orderBookMutex;
+PositionEngine positionEngine;
+ArbitrageMonitor arbitrageMonitor;
+ArbitrageMonitor::Subscription arbitrageEvents = arbitrageMonitor.subscribe(4096);
+std::mutex arbitrageEventsMutex;
+
+// Read a base URL override from the environment (used to point at mock venues for load testing)
+std::string envOr(const char* name, const std::string& fallback) {
+    const char* value = std::getenv(name);
+    return value ? std::string(value) : fallback;
+}
 
 // Callback function for CURL to write response data
 size_t WriteCallback(void* contents, size_t size, size_t nmemb, std::string* userp) {
@@ -51,7 +60,7 @@ double getCurrentPrice(const std::string& symbol) {
     std::string response;
 
     if (curl) {
-        std::string url = "https://query1.finance.yahoo.com/v8/finance/chart/" + symbol;
+        std::string url = envOr("PRICE_API_URL", "https://query1.finance.yahoo.com") + "/v8/finance/chart/" + symbol;
         curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
         curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteCallback);
         curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
@@ -86,7 +95,7 @@ std::vector<StockData> getHistoricalData(const std::string& symbol) {
         auto start = end - (250 * 24 * 60 * 60); // 250 days ago
 
         std::stringstream ss;
-        ss << "https://query1.finance.yahoo.com/v8/finance/chart/" << symbol
+        ss << envOr("PRICE_API_URL", "https://query1.finance.yahoo.com") << "/v8/finance/chart/" << symbol
            << "?period1=" << start << "&period2=" << end << "&interval=1d";
 
         curl_easy_setopt(curl, CURLOPT_URL, ss.str().c_str());
@@ -104,7 +113,7 @@ std::vector<StockData> getHistoricalData(const std::string& symbol) {
 
                 for (size_t i = 0; i < timestamps.size(); ++i) {
                     StockData stock;
-                    stock.date = std::to_string(timestamps[i]);
+                    stock.date = std::to_string(timestamps[i].get<long long>());
                     stock.open = quotes["open"][i];
                     stock.high = quotes["high"][i];
                     stock.low = quotes["low"][i];
@@ -124,7 +133,8 @@ int main() {
     curl_global_init(CURL_GLOBAL_DEFAULT);
 
     // Create Crow app
-    crow::SimpleApp app;
+    // CORSHandler must be part of the app type for get_middleware to find it
+    crow::App<crow::CORSHandler> app;
 
     // CORS middleware
     auto& cors = app.get_middleware<crow::CORSHandler>();
@@ -174,8 +184,13 @@ int main() {
                 order.status = "EXECUTED";
 
                 // Store order
-                orderBook.push_back(order);
-                lastPrices[order.symbol] = order.price;
+                {
+                    std::lock_guard<std::mutex> lock(orderBookMutex);
+                    orderBook.push_back(order);
+                    lastPrices[order.symbol] = order.price;
+                }
+                positionEngine.onPrice(order.symbol, order.price);
+                positionEngine.onFill(order.symbol, "internal", order.type, order.quantity, order.price);
 
                 json response;
                 response["orderId"] = order.id;
@@ -197,36 +212,98 @@ int main() {
     CROW_ROUTE(app, "/api/orders")
         .methods("GET"_method)
         ([]() {
-            json response;
-            for (const auto& order : orderBook) {
-                json item;
-                item["id"] = order.id;
-                item["symbol"] = order.symbol;
-                item["quantity"] = order.quantity;
-                item["type"] = order.type;
-                item["price"] = order.price;
-                item["total"] = order.total;
-                item["timestamp"] = order.timestamp;
-                item["status"] = order.status;
-                response.push_back(item);
+            // Serialize a copy so /api/order is not held up while the history is dumped
+            std::vector<Order> history;
+            {
+                std::lock_guard<std::mutex> lock(orderBookMutex);
+                history = orderBook;
             }
-            return crow::response(response.dump());
+            return crow::response(orderHistoryToJson(history).dump());
         });
 
     // API endpoint for last price
     CROW_ROUTE(app, "/api/price/<string>")
         .methods("GET"_method)
         ([](const std::string& symbol) {
-            auto it = lastPrices.find(symbol);
-            if (it == lastPrices.end()) {
-                return crow::response(404, json{{"error", "No price data available"}}.dump());
+            double price;
+            {
+                std::lock_guard<std::mutex> lock(orderBookMutex);
+                auto it = lastPrices.find(symbol);
+                if (it == lastPrices.end()) {
+                    return crow::response(404, json{{"error", "No price data available"}}.dump());
+                }
+                price = it->second;
             }
             json response;
             response["symbol"] = symbol;
-            response["price"] = it->second;
+            response["price"] = price;
+            return crow::response(response.dump());
+        });
+
+    // API endpoint for all positions (aggregated per symbol and per venue)
+    CROW_ROUTE(app, "/api/positions")
+        .methods("GET"_method)
+        ([]() {
+            return crow::response(positionEngine.positions().dump());
+        });
+
+    // API endpoint for a single symbol's position
+    CROW_ROUTE(app, "/api/positions/<string>")
+        .methods("GET"_method)
+        ([](const std::string& symbol) {
+            auto position = positionEngine.position(symbol);
+            if (position.is_null()) {
+                return crow::response(404, json{{"error", "No position for symbol"}}.dump());
+            }
+            return crow::response(position.dump());
+        });
+
+    // API endpoint for portfolio PnL
+    CROW_ROUTE(app, "/api/pnl")
+        .methods("GET"_method)
+        ([]() {
+            return crow::response(positionEngine.pnl().dump());
+        });
+
+    // API endpoint for cross-venue spread signals and opportunity statistics
+    CROW_ROUTE(app, "/api/arbitrage")
+        .methods("GET"_method)
+        ([]() {
+            return crow::response(arbitrageMonitor.snapshot().dump());
+        });
+
+    // API endpoint draining pending arbitrage events
+    CROW_ROUTE(app, "/api/arbitrage/events")
+        .methods("GET"_method)
+        ([]() {
+            json response = json::array();
+            // Crow workers share one subscription, so the consumer side is serialized here
+            std::lock_guard<std::mutex> lock(arbitrageEventsMutex);
+            ArbitrageEvent ev;
+            while (arbitrageEvents->tryPop(ev)) {
+                json item;
+                item["type"] = ArbitrageMonitor::typeName(ev.type);
+                item["pair"] = ev.pair;
+                item["buy"] = venueName(ev.buy_venue);
+                item["sell"] = venueName(ev.sell_venue);
+                item["ask"] = ev.ask;
+                item["bid"] = ev.bid;
+                item["depth"] = ev.depth;
+                item["net_edge_bps"] = ev.net_edge_bps;
+                item["duration_ns"] = ev.duration_ns;
+                item["timestamp_ns"] = ev.timestamp_ns;
+                response.push_back(item);
+            }
             return crow::response(response.dump());
         });
 
+    // Exchange APIs and the staged execution pipeline (replace with real keys/secrets in production)
+    CoinbaseAPI coinbase("API_KEY", "API_SECRET", "PASSPHRASE", envOr("COINBASE_API_URL", "https://api.exchange.coinbase.com"));
+    KrakenAPI kraken("API_KEY", "API_SECRET", envOr("KRAKEN_API_URL", "https://api.kraken.com"));
+    GeminiAPI gemini("API_KEY", "API_SECRET", envOr("GEMINI_API_URL", "https://api.gemini.com"));
+    Pipeline pipeline(PipelineConfig::fromEnv(), &coinbase, &kraken, &gemini, &arbitrageMonitor, &positionEngine);
+    pipeline.start();
+
     // API endpoint for trading on best price
     CROW_ROUTE(app, "/api/trade").methods("POST"_method)
     ([&](const crow::request& req) {
@@ -235,76 +312,42 @@ int main() {
             std::string pair = x["pair"];
             std::string side = x["side"];
             double quantity = x["quantity"];
-
-            // Initialize exchange APIs (replace with real keys/secrets in production)
-            CoinbaseAPI coinbase("API_KEY", "API_SECRET", "PASSPHRASE");
-            KrakenAPI kraken("API_KEY", "API_SECRET");
-            GeminiAPI gemini("API_KEY", "API_SECRET");
-            OrderBook ob(&coinbase, &kraken, &gemini);
-            auto consolidated = ob.buildConsolidatedOrderBook();
-            auto book = consolidated[pair];
-
-            // Find best price and exchange
-            double best_price = 0;
-            std::string best_exchange;
-            if (side == "buy") {
-                best_price = 1e12;
-                // Check asks
-                if (!book["asks"].empty()) {
-                    for (const auto& ask : book["asks"]) {
-                        if (ask[0] < best_price) best_price = ask[0];
-                    }
-                }
-            } else {
-                best_price = 0;
-                // Check bids
-                if (!book["bids"].empty()) {
-                    for (const auto& bid : book["bids"]) {
-                        if (bid[0] > best_price) best_price = bid[0];
-                    }
-                }
+            if (!normalizeSide(side)) {
+                return crow::response(400, json{{"error", "side must be buy or sell"}}.dump());
+            }
+            if (quantity <= 0.0) {
+                return crow::response(400, json{{"error", "quantity must be positive"}}.dump());
             }
 
-            // Determine which exchange has the best price
-            std::string exchanges[3] = {"coinbase", "kraken", "gemini"};
-            double prices[3] = {0, 0, 0};
-            // Fetch top-of-book from each exchange
-            prices[0] = (side == "buy") ? ob.fetchCoinbaseOrderBook(pair)["asks"][0][0] : ob.fetchCoinbaseOrderBook(pair)["bids"][0][0];
-            prices[1] = (side == "buy") ? ob.fetchKrakenOrderBook(pair)["asks"][0][0] : ob.fetchKrakenOrderBook(pair)["bids"][0][0];
-            prices[2] = (side == "buy") ? ob.fetchGeminiOrderBook(pair)["asks"][0][0] : ob.fetchGeminiOrderBook(pair)["bids"][0][0];
-            int best_idx = 0;
-            for (int i = 1; i < 3; ++i) {
-                if ((side == "buy" && prices[i] < prices[best_idx]) || (side == "sell" && prices[i] > prices[best_idx])) {
-                    best_idx = i;
-                }
+            // Venue I/O, book building and routing run on the pipeline stages; we only wait here
+            // The router enforces the trade deadline itself, so this wait only guards against a stuck pipeline
+            auto result = pipeline.submitTrade(pair, side, quantity);
+            if (result.wait_for(pipeline.replyTimeout()) != std::future_status::ready) {
+                return crow::response(504, json{{"error", "Trade outcome unknown; check /api/positions"}}.dump());
             }
-            best_exchange = exchanges[best_idx];
-
-            // Execute order on the best exchange
-            json exec_result;
-            if (best_exchange == "coinbase") {
-                exec_result = coinbase.placeOrder(side, pair, quantity);
-            } else if (best_exchange == "kraken") {
-                exec_result = kraken.placeOrder(pair, side, "market", quantity);
-            } else if (best_exchange == "gemini") {
-                exec_result = gemini.placeOrder(pair, side, quantity);
+            json response = result.get();
+            if (response.value("timed_out", false)) {
+                return crow::response(504, response.dump());
+            }
+            if (response.contains("error")) {
+                return crow::response(503, response.dump());
             }
-
-            json response;
-            response["pair"] = pair;
-            response["side"] = side;
-            response["quantity"] = quantity;
-            response["best_price"] = prices[best_idx];
-            response["exchange"] = best_exchange;
-            response["execution"] = exec_result;
             return crow::response(response.dump());
         } catch (const std::exception& e) {
             return crow::response(500, json{{"error", e.what()}}.dump());
         }
     });
 
+    // API endpoint for pipeline queue depths and per-stage service times
+    CROW_ROUTE(app, "/api/pipeline")
+        .methods("GET"_method)
+        ([&]() {
+            return crow::response(pipeline.metrics().dump());
+        });
+
     // Start server
     app.port(3000).multithreaded().run();
+    pipeline.stop();
 
     // Cleanup CURL
     curl_global_cleanup();
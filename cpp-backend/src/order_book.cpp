@@ -3,6 +3,44 @@
 #include <nlohmann/json.hpp>
 #include <algorithm>
 
+namespace {
+// Venues quote prices and sizes as strings; accept plain numbers too
+double toDouble(const nlohmann::json& value) {
+    return value.is_string() ? std::stod(value.get<std::string>()) : value.get<double>();
+}
+
+// Levels array for one side of a venue book, or nullptr if absent.
+// Kraken nests the book under result.<PAIR>; Coinbase and Gemini keep it at the top level.
+const nlohmann::json* bookSide(Venue venue, const nlohmann::json& book, const char* side) {
+    const nlohmann::json* root = &book;
+    if (venue == Venue::Kraken) {
+        if (!book.contains("result") || !book["result"].is_object() || book["result"].empty()) return nullptr;
+        root = &book["result"].begin().value();
+    }
+    if (!root->is_object() || !root->contains(side) || !(*root)[side].is_array()) return nullptr;
+    return &(*root)[side];
+}
+
+// Gemini levels are {"price","amount"} objects; Coinbase and Kraken use ["price","size",...]
+const nlohmann::json& levelPrice(Venue venue, const nlohmann::json& level) {
+    return venue == Venue::Gemini ? level.at("price") : level.at(0);
+}
+
+const nlohmann::json& levelSize(Venue venue, const nlohmann::json& level) {
+    return venue == Venue::Gemini ? level.at("amount") : level.at(1);
+}
+
+void parseLevel(Venue venue, const nlohmann::json& level, double& price, double& size) {
+    price = toDouble(levelPrice(venue, level));
+    size = toDouble(levelSize(venue, level));
+}
+
+// The venue's own decimal text; numbers are written with round-trip precision
+std::string decimalText(const nlohmann::json& value) {
+    return value.is_string() ? value.get<std::string>() : value.dump();
+}
+}
+
 OrderBook::OrderBook(CoinbaseAPI* coinbase, KrakenAPI* kraken, GeminiAPI* gemini)
     : coinbase_(coinbase), kraken_(kraken), gemini_(gemini) {}
 
@@ -13,28 +51,28 @@ std::vector<std::string> OrderBook::getTopPairs() const {
     return {"BTC-USD", "ETH-USD", "USDT-USD", "SOL-USD", "XRP-USD", "DOGE-USD", "ADA-USD", "AVAX-USD", "LINK-USD", "MATIC-USD"};
 }
 
-nlohmann::json OrderBook::fetchCoinbaseOrderBook(const std::string& pair) {
+std::unique_ptr<HttpRequest> OrderBook::prepareCoinbaseOrderBook(const std::string& pair) {
     // Coinbase uses dashes, e.g., BTC-USD
     std::string endpoint = "/products/" + pair + "/book?level=2";
-    return coinbase_->sendRequest("GET", endpoint);
+    return coinbase_->prepareRequest("GET", endpoint);
 }
 
-nlohmann::json OrderBook::fetchKrakenOrderBook(const std::string& pair) {
+std::unique_ptr<HttpRequest> OrderBook::prepareKrakenOrderBook(const std::string& pair) {
     // Kraken uses XBTUSD, ETHUSD, etc. Map as needed
     std::string kraken_pair = pair;
     if (kraken_pair == "BTC-USD") kraken_pair = "XBTUSD";
     else kraken_pair.erase(std::remove(kraken_pair.begin(), kraken_pair.end(), '-'), kraken_pair.end());
     nlohmann::json req = {{"pair", kraken_pair}};
-    return kraken_->sendRequest("/0/public/Depth", req);
+    return kraken_->prepareRequest("/0/public/Depth", req);
 }
 
-nlohmann::json OrderBook::fetchGeminiOrderBook(const std::string& pair) {
+std::unique_ptr<HttpRequest> OrderBook::prepareGeminiOrderBook(const std::string& pair) {
     // Gemini uses lowercase, no dash, e.g., btcusd
     std::string gemini_pair = pair;
     std::transform(gemini_pair.begin(), gemini_pair.end(), gemini_pair.begin(), ::tolower);
     gemini_pair.erase(std::remove(gemini_pair.begin(), gemini_pair.end(), '-'), gemini_pair.end());
     std::string endpoint = "/v1/book/" + gemini_pair;
-    return gemini_->sendRequest(endpoint, nullptr);
+    return gemini_->prepareRequest(endpoint, nullptr);
 }
 
 nlohmann::json OrderBook::mergeOrderBooks(const std::string& pair, const std::vector<nlohmann::json>& books) {
@@ -64,13 +102,61 @@ nlohmann::json OrderBook::mergeOrderBooks(const std::string& pair, const std::ve
     return merged;
 }
 
+std::unique_ptr<HttpRequest> OrderBook::prepareVenueOrderBook(Venue venue, const std::string& pair) {
+    switch (venue) {
+        case Venue::Coinbase: return prepareCoinbaseOrderBook(pair);
+        case Venue::Kraken: return prepareKrakenOrderBook(pair);
+        case Venue::Gemini: return prepareGeminiOrderBook(pair);
+        default: return nullptr;
+    }
+}
+
+nlohmann::json OrderBook::fetchVenueOrderBook(Venue venue, const std::string& pair) {
+    std::unique_ptr<HttpRequest> request = prepareVenueOrderBook(venue, pair);
+    if (!request) return nlohmann::json{{"error", "Unknown venue"}};
+    return request->perform();
+}
+
+TopOfBook OrderBook::parseTopOfBook(Venue venue, const nlohmann::json& book) {
+    // Best level first on every venue
+    TopOfBook top;
+    try {
+        const nlohmann::json* bids = bookSide(venue, book, "bids");
+        const nlohmann::json* asks = bookSide(venue, book, "asks");
+        if (bids && !bids->empty()) parseLevel(venue, bids->front(), top.bid, top.bid_size);
+        if (asks && !asks->empty()) parseLevel(venue, asks->front(), top.ask, top.ask_size);
+    } catch (const std::exception&) {
+        return TopOfBook();
+    }
+    return top;
+}
+
+nlohmann::json OrderBook::normalizeBook(Venue venue, const nlohmann::json& book) {
+    nlohmann::json normalized = {{"bids", nlohmann::json::array()}, {"asks", nlohmann::json::array()}};
+    for (const char* side : {"bids", "asks"}) {
+        const nlohmann::json* levels = bookSide(venue, book, side);
+        if (!levels) continue;
+        for (const auto& level : *levels) {
+            // Parsed only to drop malformed levels; the venue's text is passed through unrounded
+            double price = 0.0, size = 0.0;
+            try {
+                parseLevel(venue, level, price, size);
+            } catch (const std::exception&) {
+                continue;
+            }
+            normalized[side].push_back({decimalText(levelPrice(venue, level)), decimalText(levelSize(venue, level))});
+        }
+    }
+    return normalized;
+}
+
 nlohmann::json OrderBook::buildConsolidatedOrderBook() {
     nlohmann::json consolidated;
     for (const auto& pair : getTopPairs()) {
         std::vector<nlohmann::json> books;
-        books.push_back(fetchCoinbaseOrderBook(pair));
-        books.push_back(fetchKrakenOrderBook(pair));
-        books.push_back(fetchGeminiOrderBook(pair));
+        for (Venue venue : {Venue::Coinbase, Venue::Kraken, Venue::Gemini}) {
+            books.push_back(normalizeBook(venue, fetchVenueOrderBook(venue, pair)));
+        }
         consolidated[pair] = mergeOrderBooks(pair, books);
     }
     return consolidated;
@@ -0,0 +1,18 @@
+#include "order_history.h"
+
+nlohmann::json orderHistoryToJson(const std::vector<Order>& orders) {
+    nlohmann::json response;
+    for (const auto& order : orders) {
+        nlohmann::json item;
+        item["id"] = order.id;
+        item["symbol"] = order.symbol;
+        item["quantity"] = order.quantity;
+        item["type"] = order.type;
+        item["price"] = order.price;
+        item["total"] = order.total;
+        item["timestamp"] = order.timestamp;
+        item["status"] = order.status;
+        response.push_back(item);
+    }
+    return response;
+}
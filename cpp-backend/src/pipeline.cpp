@@ -0,0 +1,687 @@
+#include "pipeline.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace {
+// Idle polls before an unpinned stage starts sleeping between polls
+constexpr unsigned kSpinLimit = 4096;
+// Every venue except Internal gets an I/O stage
+constexpr std::size_t kExchangeCount = kVenueCount - 1;
+// How often the router looks for trades past their deadline
+constexpr std::int64_t kExpiryIntervalNs = 1000000;
+// Slack on top of the pipeline's own deadlines before a caller gives up on a reply
+constexpr long kReplySlackMs = 5000;
+
+// Public market-data requests per second each venue tolerates: Coinbase 10/s,
+// Kraken about 1/s (call counter decays by one per second), Gemini 120/min
+double publicRateLimit(Venue venue) {
+    switch (venue) {
+    case Venue::Coinbase: return 10.0;
+    case Venue::Kraken: return 1.0;
+    case Venue::Gemini: return 2.0;
+    default: return 1.0;
+    }
+}
+
+void idle(unsigned& spins, bool pinned) {
+    if (++spins < kSpinLimit) return;
+    // Pinned stages own their core and keep polling; unpinned ones back off
+    if (pinned) std::this_thread::yield();
+    else std::this_thread::sleep_for(std::chrono::microseconds(50));
+}
+
+void copyField(char* dst, std::size_t size, const std::string& src) {
+    std::memset(dst, 0, size);
+    std::strncpy(dst, src.c_str(), size - 1);
+}
+
+// Venue amounts arrive as decimal strings; -1 when missing or malformed
+double amountField(const nlohmann::json& response, const char* key) {
+    auto it = response.find(key);
+    if (it == response.end()) return -1.0;
+    try {
+        if (it->is_string()) return std::stod(it->get<std::string>());
+        if (it->is_number()) return it->get<double>();
+    } catch (const std::exception&) {
+    }
+    return -1.0;
+}
+
+std::string reasonField(const nlohmann::json& response, const char* key) {
+    auto it = response.find(key);
+    if (it == response.end()) return "";
+    return it->is_string() ? it->get<std::string>() : it->dump();
+}
+}
+
+PipelineConfig PipelineConfig::fromEnv() {
+    PipelineConfig config;
+    if (const char* poll = std::getenv("PIPELINE_POLL_MS")) {
+        try {
+            config.poll_interval_ms = std::stol(poll);
+        } catch (const std::exception&) {
+        }
+    }
+    const char* env = std::getenv("PIPELINE_CORES");
+    if (!env) return config;
+    std::vector<int> cores;
+    std::stringstream ss(env);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        try {
+            cores.push_back(std::stoi(item));
+        } catch (const std::exception&) {
+            cores.push_back(-1);
+        }
+    }
+    const Venue order[] = {Venue::Coinbase, Venue::Kraken, Venue::Gemini};
+    for (std::size_t i = 0; i < 3 && i < cores.size(); ++i) {
+        config.io_cores[static_cast<std::size_t>(order[i])] = cores[i];
+    }
+    if (cores.size() > 3) config.book_core = cores[3];
+    if (cores.size() > 4) config.router_core = cores[4];
+    return config;
+}
+
+Pipeline::Pipeline(const PipelineConfig& config, CoinbaseAPI* coinbase, KrakenAPI* kraken, GeminiAPI* gemini,
+                   ArbitrageMonitor* monitor, PositionEngine* positions)
+    : config_(config), coinbase_(coinbase), kraken_(kraken), gemini_(gemini),
+      monitor_(monitor), positions_(positions), books_(coinbase, kraken, gemini),
+      ingress_(config.ring_capacity), book_to_router_(config.ring_capacity) {
+    for (std::size_t i = 0; i < kVenueCount; ++i) {
+        if (!isExchange(static_cast<Venue>(i))) continue;
+        to_io_orders_[i].reset(new Ring(config.ring_capacity));
+        to_io_books_[i].reset(new Ring(config.ring_capacity));
+        io_to_book_[i].reset(new Ring(config.ring_capacity));
+        io_to_router_[i].reset(new Ring(config.ring_capacity));
+        io_stats_[i].requested_core = config.io_cores[i];
+        io_multi_[i] = curl_multi_init();
+    }
+    book_stats_.requested_core = config.book_core;
+    router_stats_.requested_core = config.router_core;
+}
+
+Pipeline::~Pipeline() {
+    stop();
+    for (CURLM* multi : io_multi_) {
+        if (multi) curl_multi_cleanup(multi);
+    }
+}
+
+int Pipeline::pinToCore(int core, const char* stage) {
+    if (core < 0) return -1;
+#ifdef __linux__
+    if (core >= CPU_SETSIZE) {
+        std::cerr << "Pipeline: " << stage << " core " << core << " is out of range, running unpinned" << std::endl;
+        return -1;
+    }
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(core, &set);
+    int rc = pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+    if (rc != 0) {
+        std::cerr << "Pipeline: failed to pin " << stage << " to core " << core << ": " << std::strerror(rc)
+                  << ", running unpinned" << std::endl;
+        return -1;
+    }
+    return core;
+#else
+    std::cerr << "Pipeline: core pinning is not supported here, " << stage << " runs unpinned" << std::endl;
+    return -1;
+#endif
+}
+
+void Pipeline::start() {
+    if (running_.exchange(true)) return;
+    for (std::size_t i = 0; i < kVenueCount; ++i) {
+        Venue venue = static_cast<Venue>(i);
+        if (!isExchange(venue)) continue;
+        threads_.emplace_back([this, venue]() { ioLoop(venue); });
+    }
+    threads_.emplace_back([this]() { bookLoop(); });
+    threads_.emplace_back([this]() { routerLoop(); });
+}
+
+void Pipeline::stop() {
+    {
+        std::lock_guard<std::mutex> lock(ingress_mutex_);
+        if (!running_.exchange(false)) return;
+    }
+    // I/O threads may be waiting on sockets
+    for (CURLM* multi : io_multi_) {
+        if (multi) curl_multi_wakeup(multi);
+    }
+    for (auto& t : threads_) t.join();
+    threads_.clear();
+    // Release payloads still in flight and fail any trade that never completed
+    drain(ingress_);
+    for (std::size_t i = 0; i < kVenueCount; ++i) {
+        if (to_io_orders_[i]) drain(*to_io_orders_[i]);
+        if (to_io_books_[i]) drain(*to_io_books_[i]);
+        if (io_to_book_[i]) drain(*io_to_book_[i]);
+        if (io_to_router_[i]) drain(*io_to_router_[i]);
+    }
+    drain(book_to_router_);
+    for (auto& entry : pending_) {
+        entry.second.reply->set_value(nlohmann::json{{"error", "Pipeline stopped"}});
+        delete entry.second.reply;
+    }
+    pending_.clear();
+    pending_count_ = 0;
+}
+
+void Pipeline::drain(Ring& ring) {
+    PipelineMessage msg;
+    while (ring.tryPop(msg)) {
+        delete msg.payload;
+        if (msg.reply) {
+            msg.reply->set_value(nlohmann::json{{"error", "Pipeline stopped"}});
+            delete msg.reply;
+        }
+    }
+}
+
+bool Pipeline::pushBlocking(Ring& ring, const PipelineMessage& msg) {
+    unsigned spins = 0;
+    while (!ring.tryPush(msg)) {
+        if (!running_.load(std::memory_order_relaxed)) return false;
+        idle(spins, true);
+    }
+    return true;
+}
+
+void Pipeline::recordService(StageStats& stats, const PipelineMessage& msg, std::int64_t start_ns) {
+    // Only the owning stage thread writes its stats, so plain load/store is enough
+    double service = static_cast<double>(steadyNowNs() - start_ns);
+    double queued = static_cast<double>(start_ns - msg.enqueued_ns);
+    std::uint64_t n = stats.processed.load(std::memory_order_relaxed) + 1;
+    double ewma = stats.ewma_service_ns.load(std::memory_order_relaxed);
+    double ewma_q = stats.ewma_queue_ns.load(std::memory_order_relaxed);
+    stats.ewma_service_ns.store(n == 1 ? service : ewma + kEwmaAlpha * (service - ewma), std::memory_order_relaxed);
+    stats.ewma_queue_ns.store(n == 1 ? queued : ewma_q + kEwmaAlpha * (queued - ewma_q), std::memory_order_relaxed);
+    if (service > stats.max_service_ns.load(std::memory_order_relaxed)) {
+        stats.max_service_ns.store(service, std::memory_order_relaxed);
+    }
+    stats.processed.store(n, std::memory_order_relaxed);
+}
+
+std::future<nlohmann::json> Pipeline::submitTrade(const std::string& pair, const std::string& side, double quantity) {
+    auto* reply = new std::promise<nlohmann::json>();
+    std::future<nlohmann::json> result = reply->get_future();
+
+    // The router compares sides verbatim, so only normalized buy/sell gets in
+    std::string normalized = side;
+    if (!normalizeSide(normalized)) {
+        reply->set_value(nlohmann::json{{"error", "side must be buy or sell"}});
+        delete reply;
+        return result;
+    }
+
+    PipelineMessage msg{};
+    msg.kind = PipelineMessage::Kind::Trade;
+    msg.request_id = next_request_id_.fetch_add(1, std::memory_order_relaxed);
+    copyField(msg.pair, sizeof(msg.pair), pair);
+    copyField(msg.side, sizeof(msg.side), normalized);
+    msg.quantity = quantity;
+    msg.reply = reply;
+    msg.enqueued_ns = steadyNowNs();
+    msg.deadline_ns = msg.enqueued_ns + config_.trade_timeout_ms * 1000000;
+
+    bool accepted = false;
+    {
+        // Checked under the lock so stop() cannot drain ingress between the check and the push
+        std::lock_guard<std::mutex> lock(ingress_mutex_);
+        accepted = running_.load(std::memory_order_acquire) && ingress_.tryPush(msg);
+    }
+    if (!accepted) {
+        reply->set_value(nlohmann::json{{"error", "Pipeline busy"}});
+        delete reply;
+    }
+    return result;
+}
+
+std::unique_ptr<HttpRequest> Pipeline::prepareOrder(Venue venue, const PipelineMessage& msg) {
+    switch (venue) {
+        case Venue::Coinbase: return coinbase_->prepareOrder(msg.side, msg.pair, msg.quantity);
+        case Venue::Kraken: return kraken_->prepareOrder(msg.pair, msg.side, "market", msg.quantity);
+        case Venue::Gemini: return gemini_->prepareOrder(msg.pair, msg.side, msg.quantity);
+        default: return nullptr;
+    }
+}
+
+void Pipeline::startTransfer(Venue venue, const PipelineMessage& msg, std::unordered_map<CURL*, Transfer>& in_flight) {
+    std::size_t v = static_cast<std::size_t>(venue);
+    Transfer transfer;
+    transfer.msg = msg;
+    transfer.start_ns = steadyNowNs();
+    transfer.request = msg.kind == PipelineMessage::Kind::PlaceOrder ? prepareOrder(venue, msg)
+                                                                     : books_.prepareVenueOrderBook(venue, msg.pair);
+    if (!transfer.request) {
+        finishTransfer(venue, transfer, CURLE_FAILED_INIT);
+        return;
+    }
+    transfer.request->setTimeout(config_.venue_timeout_ms);
+    CURL* handle = transfer.request->handle();
+    if (curl_multi_add_handle(io_multi_[v], handle) != CURLM_OK) {
+        finishTransfer(venue, transfer, CURLE_FAILED_INIT);
+        return;
+    }
+    in_flight.emplace(handle, std::move(transfer));
+}
+
+void Pipeline::finishTransfer(Venue venue, Transfer& transfer, CURLcode code) {
+    std::size_t v = static_cast<std::size_t>(venue);
+    const PipelineMessage& msg = transfer.msg;
+    bool book = msg.kind == PipelineMessage::Kind::FetchBook;
+    PipelineMessage out = msg;
+    out.kind = book ? PipelineMessage::Kind::BookSnapshot : PipelineMessage::Kind::Execution;
+    out.payload = new nlohmann::json(transfer.request ? transfer.request->result(code)
+                                                      : nlohmann::json{{"error", "Unknown venue"}});
+    recordService(io_stats_[v], msg, transfer.start_ns);
+    out.enqueued_ns = steadyNowNs();
+    if (!pushBlocking(book ? *io_to_book_[v] : *io_to_router_[v], out)) delete out.payload;
+}
+
+void Pipeline::ioLoop(Venue venue) {
+    std::size_t v = static_cast<std::size_t>(venue);
+    io_stats_[v].core = pinToCore(config_.io_cores[v], venueName(venue));
+    bool pinned = io_stats_[v].core >= 0;
+    Ring& orders = *to_io_orders_[v];
+    Ring& fetches = *to_io_books_[v];
+    CURLM* multi = io_multi_[v];
+    std::unordered_map<CURL*, Transfer> in_flight;
+    unsigned spins = 0;
+    PipelineMessage msg;
+    while (running_.load(std::memory_order_relaxed)) {
+        // Orders go out as soon as they arrive; book fetches fill the remaining slots
+        while (orders.tryPop(msg)) startTransfer(venue, msg, in_flight);
+        while (in_flight.size() < config_.max_in_flight && fetches.tryPop(msg)) {
+            startTransfer(venue, msg, in_flight);
+        }
+        io_in_flight_[v].store(in_flight.size(), std::memory_order_relaxed);
+        if (in_flight.empty()) {
+            idle(spins, pinned);
+            continue;
+        }
+        spins = 0;
+
+        int running = 0;
+        curl_multi_perform(multi, &running);
+        int queued = 0;
+        while (CURLMsg* info = curl_multi_info_read(multi, &queued)) {
+            if (info->msg != CURLMSG_DONE) continue;
+            // info is invalidated by remove_handle, so copy what we need first
+            CURL* handle = info->easy_handle;
+            CURLcode code = info->data.result;
+            curl_multi_remove_handle(multi, handle);
+            auto it = in_flight.find(handle);
+            if (it == in_flight.end()) continue;
+            finishTransfer(venue, it->second, code);
+            in_flight.erase(it);
+        }
+        if (in_flight.empty()) continue;
+        // Pinned stages keep polling; otherwise sleep until a socket is ready or the router wakes us
+        curl_multi_poll(multi, nullptr, 0, pinned ? 0 : 100, nullptr);
+    }
+    // Abandon transfers still in flight; stop() fails the trades waiting on them
+    for (auto& entry : in_flight) curl_multi_remove_handle(multi, entry.first);
+    in_flight.clear();
+    io_in_flight_[v].store(0, std::memory_order_relaxed);
+}
+
+void Pipeline::bookLoop() {
+    book_stats_.core = pinToCore(config_.book_core, "book");
+    bool pinned = book_stats_.core >= 0;
+    unsigned spins = 0;
+    PipelineMessage msg;
+    while (running_.load(std::memory_order_relaxed)) {
+        bool worked = false;
+        for (std::size_t v = 0; v < kVenueCount; ++v) {
+            if (!io_to_book_[v] || !io_to_book_[v]->tryPop(msg)) continue;
+            worked = true;
+            std::int64_t start = steadyNowNs();
+            PipelineMessage out = msg;
+            out.kind = PipelineMessage::Kind::TopOfBook;
+            out.top = OrderBook::parseTopOfBook(msg.venue, *msg.payload);
+            out.payload = nullptr;
+            delete msg.payload;
+            // Stamped with when the venue answered, not when we got round to parsing it
+            if (monitor_) {
+                monitor_->onTopOfBook(msg.pair, msg.venue, out.top.bid, out.top.bid_size, out.top.ask, out.top.ask_size,
+                                      msg.enqueued_ns);
+            }
+            // Every book is a price tick for the position engine
+            if (positions_ && out.top.bid > 0.0 && out.top.ask > 0.0) {
+                positions_->onPrice(msg.pair, (out.top.bid + out.top.ask) / 2.0);
+            }
+            recordService(book_stats_, msg, start);
+            // Polled books stop here; only trades need the router
+            if (msg.request_id == 0) {
+                polls_outstanding_[v].fetch_sub(1, std::memory_order_relaxed);
+                continue;
+            }
+            out.enqueued_ns = steadyNowNs();
+            pushBlocking(book_to_router_, out);
+        }
+        if (worked) spins = 0;
+        else idle(spins, pinned);
+    }
+}
+
+void Pipeline::routerLoop() {
+    router_stats_.core = pinToCore(config_.router_core, "router");
+    bool pinned = router_stats_.core >= 0;
+    unsigned spins = 0;
+    std::int64_t next_expiry_ns = 0;
+    std::int64_t next_poll_ns = 0;
+    PipelineMessage msg;
+    // The router never blocks on a push, so upstream stages can always make progress
+    while (running_.load(std::memory_order_relaxed)) {
+        bool worked = false;
+        if (!pending_.empty()) {
+            std::int64_t now = steadyNowNs();
+            if (now >= next_expiry_ns) {
+                expireTrades(now);
+                next_expiry_ns = now + kExpiryIntervalNs;
+            }
+        }
+        if (config_.poll_interval_ms > 0) {
+            std::int64_t now = steadyNowNs();
+            if (now >= next_poll_ns) {
+                pollBooks(now);
+                next_poll_ns = now + config_.poll_interval_ms * 1000000;
+            }
+        }
+        while (book_to_router_.tryPop(msg)) {
+            std::int64_t start = steadyNowNs();
+            routeTopOfBook(msg);
+            recordService(router_stats_, msg, start);
+            worked = true;
+        }
+        for (std::size_t v = 0; v < kVenueCount; ++v) {
+            while (io_to_router_[v] && io_to_router_[v]->tryPop(msg)) {
+                std::int64_t start = steadyNowNs();
+                routeExecution(msg);
+                recordService(router_stats_, msg, start);
+                worked = true;
+            }
+        }
+        if (ingress_.tryPop(msg)) {
+            std::int64_t start = steadyNowNs();
+            routeTrade(msg);
+            recordService(router_stats_, msg, start);
+            worked = true;
+        }
+        if (worked) spins = 0;
+        else idle(spins, pinned);
+    }
+}
+
+bool Pipeline::queueForIo(Ring& ring, Venue venue, const PipelineMessage& msg) {
+    if (!ring.tryPush(msg)) return false;
+    // Cut short the I/O thread's wait for socket activity so the new call starts now
+    curl_multi_wakeup(io_multi_[static_cast<std::size_t>(venue)]);
+    return true;
+}
+
+void Pipeline::failTrade(std::uint64_t request_id, const std::string& error, bool timed_out) {
+    auto it = pending_.find(request_id);
+    if (it == pending_.end()) return;
+    nlohmann::json response = {{"error", error}};
+    if (timed_out) response["timed_out"] = true;
+    it->second.reply->set_value(response);
+    delete it->second.reply;
+    pending_.erase(it);
+    pending_count_.store(pending_.size(), std::memory_order_relaxed);
+}
+
+void Pipeline::expireTrades(std::int64_t now_ns) {
+    // Trades already sent to a venue are left alone; the venue call has its own timeout
+    std::vector<std::uint64_t> expired;
+    for (const auto& entry : pending_) {
+        if (!entry.second.ordered && now_ns >= entry.second.deadline_ns) expired.push_back(entry.first);
+    }
+    for (std::uint64_t request_id : expired) {
+        failTrade(request_id, "Trade timed out before an order was placed", true);
+    }
+}
+
+void Pipeline::pollBooks(std::int64_t now_ns) {
+    std::vector<std::string> pairs = books_.getTopPairs();
+    for (std::size_t v = 0; v < kVenueCount; ++v) {
+        if (!to_io_books_[v]) continue;
+        if (now_ns < next_poll_ns_[v]) continue;
+        // Skip a venue while any fetch of the previous round is queued, in flight or unparsed,
+        // so polls never pile up in front of the fetches trades are waiting on
+        if (polls_outstanding_[v].load(std::memory_order_relaxed) > 0) continue;
+        for (const auto& pair : pairs) {
+            PipelineMessage out{};
+            out.kind = PipelineMessage::Kind::FetchBook;
+            out.venue = static_cast<Venue>(v);
+            out.request_id = 0;
+            copyField(out.pair, sizeof(out.pair), pair);
+            out.enqueued_ns = steadyNowNs();
+            // Counted before the push so the book builder never sees its snapshot first
+            polls_outstanding_[v].fetch_add(1, std::memory_order_relaxed);
+            if (!queueForIo(*to_io_books_[v], out.venue, out)) {
+                polls_outstanding_[v].fetch_sub(1, std::memory_order_relaxed);
+                break;
+            }
+        }
+        // A round is one request per pair; space rounds so the venue's rate limit holds
+        double round_ms = static_cast<double>(pairs.size()) * 1000.0 / publicRateLimit(static_cast<Venue>(v));
+        double interval_ms = std::max(static_cast<double>(config_.poll_interval_ms), round_ms);
+        next_poll_ns_[v] = now_ns + static_cast<std::int64_t>(interval_ms * 1e6);
+    }
+}
+
+void Pipeline::routeTrade(const PipelineMessage& msg) {
+    PendingTrade trade;
+    trade.reply = msg.reply;
+    trade.pair = msg.pair;
+    trade.side = msg.side;
+    trade.quantity = msg.quantity;
+    trade.deadline_ns = msg.deadline_ns;
+    pending_.emplace(msg.request_id, trade);
+    pending_count_.store(pending_.size(), std::memory_order_relaxed);
+
+    // Fan out a book fetch to every venue
+    for (std::size_t v = 0; v < kVenueCount; ++v) {
+        if (!to_io_books_[v]) continue;
+        PipelineMessage out = msg;
+        out.kind = PipelineMessage::Kind::FetchBook;
+        out.venue = static_cast<Venue>(v);
+        out.reply = nullptr;
+        out.enqueued_ns = steadyNowNs();
+        if (!queueForIo(*to_io_books_[v], out.venue, out)) {
+            // Stray TopOfBook messages for this id are ignored once it is no longer pending
+            failTrade(msg.request_id, "Pipeline busy");
+            return;
+        }
+    }
+}
+
+void Pipeline::routeTopOfBook(const PipelineMessage& msg) {
+    auto it = pending_.find(msg.request_id);
+    if (it == pending_.end()) return;
+    PendingTrade& trade = it->second;
+    trade.quotes[static_cast<std::size_t>(msg.venue)] = msg.top;
+    if (++trade.received < kExchangeCount) return;
+    // Never place an order for a trade the caller has been told timed out
+    if (steadyNowNs() >= trade.deadline_ns) {
+        failTrade(msg.request_id, "Trade timed out before an order was placed", true);
+        return;
+    }
+
+    // All venues reported: pick the best top of book for the side
+    bool buy = trade.side == "buy";
+    int best = -1;
+    double best_price = 0.0;
+    for (std::size_t v = 0; v < kVenueCount; ++v) {
+        if (!to_io_books_[v]) continue;
+        double price = buy ? trade.quotes[v].ask : trade.quotes[v].bid;
+        if (price <= 0.0) continue;
+        if (best < 0 || (buy && price < best_price) || (!buy && price > best_price)) {
+            best = static_cast<int>(v);
+            best_price = price;
+        }
+    }
+    if (best < 0) {
+        failTrade(msg.request_id, "No liquidity on any venue");
+        return;
+    }
+
+    PipelineMessage out{};
+    out.kind = PipelineMessage::Kind::PlaceOrder;
+    out.venue = static_cast<Venue>(best);
+    out.request_id = msg.request_id;
+    copyField(out.pair, sizeof(out.pair), trade.pair);
+    copyField(out.side, sizeof(out.side), trade.side);
+    out.quantity = trade.quantity;
+    out.price = best_price;
+    out.enqueued_ns = steadyNowNs();
+    if (!queueForIo(*to_io_orders_[best], out.venue, out)) {
+        failTrade(msg.request_id, "Pipeline busy");
+        return;
+    }
+    trade.ordered = true;
+}
+
+void Pipeline::routeExecution(PipelineMessage& msg) {
+    std::unique_ptr<nlohmann::json> exec_result(msg.payload);
+    auto it = pending_.find(msg.request_id);
+    if (it == pending_.end()) return;
+    PendingTrade& trade = it->second;
+
+    nlohmann::json response;
+    response["pair"] = trade.pair;
+    response["side"] = trade.side;
+    response["quantity"] = trade.quantity;
+    response["best_price"] = msg.price;
+    response["exchange"] = venueName(msg.venue);
+    response["execution"] = *exec_result;
+
+    ExecutionReport report = parseExecution(msg.venue, *exec_result, trade.quantity);
+    response["accepted"] = report.accepted;
+    response["filled_quantity"] = report.filled_quantity;
+    if (!report.accepted) {
+        response["error"] = std::string("Order rejected by ") + venueName(msg.venue) + ": " + report.error;
+    }
+
+    // Record what actually executed against the executing venue
+    if (positions_ && report.filled_quantity > 0) {
+        positions_->onFill(trade.pair, venueName(msg.venue), trade.side, report.filled_quantity, msg.price);
+    }
+
+    trade.reply->set_value(response);
+    delete trade.reply;
+    pending_.erase(it);
+    pending_count_.store(pending_.size(), std::memory_order_relaxed);
+}
+
+std::chrono::milliseconds Pipeline::replyTimeout() const {
+    return std::chrono::milliseconds(config_.trade_timeout_ms + config_.venue_timeout_ms + kReplySlackMs);
+}
+
+nlohmann::json Pipeline::statsToJson(const StageStats& stats) {
+    return {
+        {"requested_core", stats.requested_core},
+        {"core", stats.core.load(std::memory_order_relaxed)},
+        {"processed", stats.processed.load(std::memory_order_relaxed)},
+        {"ewma_service_ns", stats.ewma_service_ns.load(std::memory_order_relaxed)},
+        {"max_service_ns", stats.max_service_ns.load(std::memory_order_relaxed)},
+        {"ewma_queue_ns", stats.ewma_queue_ns.load(std::memory_order_relaxed)}
+    };
+}
+
+ExecutionReport Pipeline::parseExecution(Venue venue, const nlohmann::json& response, double quantity) {
+    ExecutionReport report;
+    if (!response.is_object()) {
+        report.error = "unexpected response";
+        return report;
+    }
+    // Transport and parse failures from HttpRequest
+    auto failure = response.find("error");
+    if (failure != response.end() && failure->is_string()) {
+        report.error = failure->get<std::string>();
+        return report;
+    }
+
+    switch (venue) {
+    case Venue::Kraken: {
+        // Kraken always sends "error"; an accepted order has it empty and carries a txid
+        bool clean = failure == response.end() || (failure->is_array() && failure->empty());
+        auto result = response.find("result");
+        bool has_txid = result != response.end() && result->is_object() && result->contains("txid") &&
+                        (*result)["txid"].is_array() && !(*result)["txid"].empty();
+        report.accepted = clean && has_txid;
+        if (!report.accepted) {
+            report.error = clean ? "no txid in response" : reasonField(response, "error");
+            return report;
+        }
+        // AddOrder only acknowledges; the market order is booked as requested
+        report.filled_quantity = quantity;
+        return report;
+    }
+    case Venue::Coinbase: {
+        report.accepted = response.contains("id");
+        if (!report.accepted) {
+            report.error = response.contains("message") ? reasonField(response, "message") : "no order id in response";
+            return report;
+        }
+        // filled_size is final only once the order is done; before that it is booked as requested
+        double filled = amountField(response, "filled_size");
+        bool done = response.value("status", "") == "done" || response.value("settled", false);
+        report.filled_quantity = (done && filled >= 0) ? filled : quantity;
+        return report;
+    }
+    case Venue::Gemini: {
+        report.accepted = response.contains("order_id");
+        if (!report.accepted) {
+            report.error = response.contains("reason") ? reasonField(response, "reason")
+                         : response.contains("message") ? reasonField(response, "message")
+                         : "no order_id in response";
+            return report;
+        }
+        double executed = amountField(response, "executed_amount");
+        report.filled_quantity = executed >= 0 ? executed : quantity;
+        return report;
+    }
+    default:
+        report.error = "not an exchange";
+        return report;
+    }
+}
+
+nlohmann::json Pipeline::metrics() const {
+    nlohmann::json result;
+    result["running"] = running_.load();
+    result["pending_trades"] = pending_count_.load(std::memory_order_relaxed);
+    auto depth = [](const Ring& ring) {
+        return nlohmann::json{{"depth", ring.size()}, {"capacity", ring.capacity()}};
+    };
+    result["queues"]["ingress"] = depth(ingress_);
+    result["queues"]["book_to_router"] = depth(book_to_router_);
+    for (std::size_t v = 0; v < kVenueCount; ++v) {
+        if (!to_io_books_[v]) continue;
+        std::string name = venueName(static_cast<Venue>(v));
+        result["queues"]["router_to_" + name + "_orders"] = depth(*to_io_orders_[v]);
+        result["queues"]["router_to_" + name + "_books"] = depth(*to_io_books_[v]);
+        result["queues"][name + "_to_book"] = depth(*io_to_book_[v]);
+        result["queues"][name + "_to_router"] = depth(*io_to_router_[v]);
+        result["stages"]["io_" + name] = statsToJson(io_stats_[v]);
+        result["stages"]["io_" + name]["in_flight"] = io_in_flight_[v].load(std::memory_order_relaxed);
+        result["stages"]["io_" + name]["polls_outstanding"] = polls_outstanding_[v].load(std::memory_order_relaxed);
+    }
+    result["stages"]["book"] = statsToJson(book_stats_);
+    result["stages"]["router"] = statsToJson(router_stats_);
+    return result;
+}
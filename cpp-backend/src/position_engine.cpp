@@ -0,0 +1,135 @@
+#include "position_engine.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+// Positions smaller than this fraction of the traded size are floating-point residue, not exposure
+constexpr double kFlatTolerance = 1e-9;
+}
+
+PositionEngine::PositionEngine() {}
+
+PositionEngine::~PositionEngine() {}
+
+std::size_t PositionEngine::slotFor(const std::string& symbol) {
+    auto it = index_.find(symbol);
+    if (it != index_.end()) return it->second;
+    std::size_t idx = instruments_.size();
+    instruments_.emplace_back();
+    instruments_.back().symbol = symbol;
+    index_.emplace(symbol, idx);
+    return idx;
+}
+
+void PositionEngine::applyFill(Slot& slot, double signed_qty, double price) {
+    double prev = slot.net;
+    double next = prev + signed_qty;
+    if (std::fabs(next) <= kFlatTolerance * std::max(std::fabs(prev), std::fabs(signed_qty))) {
+        next = 0.0;
+    }
+    if (prev == 0.0 || (prev > 0.0) == (signed_qty > 0.0)) {
+        // Opening or adding: blend into the average cost
+        double size = std::fabs(prev) + std::fabs(signed_qty);
+        slot.avg_cost = (slot.avg_cost * std::fabs(prev) + price * std::fabs(signed_qty)) / size;
+        slot.net = next;
+        return;
+    }
+    // Reducing, closing or flipping: realize PnL on the closed quantity
+    double closed = next == 0.0 ? std::fabs(prev) : std::min(std::fabs(signed_qty), std::fabs(prev));
+    slot.realized += closed * (price - slot.avg_cost) * (prev > 0.0 ? 1.0 : -1.0);
+    slot.net = next;
+    if (next == 0.0) {
+        slot.avg_cost = 0.0;
+    } else if ((next > 0.0) != (prev > 0.0)) {
+        // Flipped through flat: the remainder opens at the fill price
+        slot.avg_cost = price;
+    }
+}
+
+void PositionEngine::markSlot(Slot& slot, double mark) {
+    slot.unrealized = mark > 0.0 ? slot.net * (mark - slot.avg_cost) : 0.0;
+}
+
+bool PositionEngine::onFill(const std::string& symbol, const std::string& venue, const std::string& side, double quantity, double price) {
+    std::string normalized = side;
+    if (quantity <= 0.0 || price <= 0.0 || !normalizeSide(normalized)) return false;
+    double signed_qty = normalized == "sell" ? -quantity : quantity;
+    std::lock_guard<std::mutex> lock(mutex_);
+    Instrument& inst = instruments_[slotFor(symbol)];
+    Slot& v = inst.venues[static_cast<std::size_t>(parseVenue(venue))];
+    inst.mark = price;
+
+    double realized_before = inst.total.realized;
+    double unrealized_before = inst.total.unrealized;
+
+    applyFill(v, signed_qty, price);
+    applyFill(inst.total, signed_qty, price);
+    // A fill moves the mark, so every venue slot of this instrument is re-marked
+    for (auto& s : inst.venues) markSlot(s, inst.mark);
+    markSlot(inst.total, inst.mark);
+
+    total_realized_ += inst.total.realized - realized_before;
+    total_unrealized_ += inst.total.unrealized - unrealized_before;
+    ++fill_count_;
+    return true;
+}
+
+void PositionEngine::onPrice(const std::string& symbol, double price) {
+    if (price <= 0.0) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(symbol);
+    if (it == index_.end()) return;
+    Instrument& inst = instruments_[it->second];
+    inst.mark = price;
+    double unrealized_before = inst.total.unrealized;
+    for (auto& s : inst.venues) markSlot(s, price);
+    markSlot(inst.total, price);
+    total_unrealized_ += inst.total.unrealized - unrealized_before;
+}
+
+nlohmann::json PositionEngine::slotToJson(const Slot& slot) {
+    return {
+        {"net", slot.net},
+        {"avg_cost", slot.avg_cost},
+        {"realized_pnl", slot.realized},
+        {"unrealized_pnl", slot.unrealized}
+    };
+}
+
+nlohmann::json PositionEngine::instrumentToJson(const Instrument& inst) {
+    nlohmann::json item = slotToJson(inst.total);
+    item["symbol"] = inst.symbol;
+    item["mark"] = inst.mark;
+    item["venues"] = nlohmann::json::object();
+    for (std::size_t i = 0; i < kVenueCount; ++i) {
+        const Slot& s = inst.venues[i];
+        if (s.net == 0.0 && s.realized == 0.0) continue;
+        item["venues"][venueName(static_cast<Venue>(i))] = slotToJson(s);
+    }
+    return item;
+}
+
+nlohmann::json PositionEngine::positions() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    nlohmann::json result = nlohmann::json::array();
+    for (const auto& inst : instruments_) result.push_back(instrumentToJson(inst));
+    return result;
+}
+
+nlohmann::json PositionEngine::position(const std::string& symbol) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = index_.find(symbol);
+    if (it == index_.end()) return nullptr;
+    return instrumentToJson(instruments_[it->second]);
+}
+
+nlohmann::json PositionEngine::pnl() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return {
+        {"realized_pnl", total_realized_},
+        {"unrealized_pnl", total_unrealized_},
+        {"total_pnl", total_realized_ + total_unrealized_},
+        {"instruments", instruments_.size()},
+        {"fills", fill_count_}
+    };
+}
@@ -0,0 +1,137 @@
+#include "arbitrage_monitor.h"
+#include "check.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Checks the per-leg state machine, published events and rolling statistics of ArbitrageMonitor.
+// Quotes carry explicit timestamps so durations and staleness are deterministic.
+
+namespace {
+
+std::vector<ArbitrageEvent> drain(ArbitrageMonitor::Subscription& sub) {
+    std::vector<ArbitrageEvent> events;
+    ArbitrageEvent ev;
+    while (sub->tryPop(ev)) events.push_back(ev);
+    return events;
+}
+
+const nlohmann::json* findLeg(const nlohmann::json& snapshot, const std::string& pair, const char* buy, const char* sell) {
+    if (!snapshot["pairs"].contains(pair)) return nullptr;
+    for (const auto& leg : snapshot["pairs"][pair]["legs"]) {
+        if (leg["buy"] == buy && leg["sell"] == sell) return &leg;
+    }
+    return nullptr;
+}
+
+constexpr std::int64_t kMs = 1000000;
+
+void testCrossedLockedClosedLifecycle() {
+    ArbitrageMonitor monitor;
+    for (Venue v : {Venue::Coinbase, Venue::Kraken, Venue::Gemini}) monitor.setTakerFee(v, 0.0);
+    auto sub = monitor.subscribe(64);
+
+    // Coinbase 99/101, Kraken 98/100: every bid is below every other venue's ask
+    monitor.onTopOfBook("BTC-USD", Venue::Coinbase, 99.0, 1.0, 101.0, 2.0, 1000 * kMs);
+    monitor.onTopOfBook("BTC-USD", Venue::Kraken, 98.0, 1.0, 100.0, 3.0, 1001 * kMs);
+    auto events = drain(sub);
+    check(events.empty(), "no signal while spreads overlap");
+
+    // Coinbase bid lifts above Kraken ask: buy Kraken / sell Coinbase is crossed
+    monitor.onTopOfBook("BTC-USD", Venue::Coinbase, 100.5, 1.5, 101.0, 2.0, 1010 * kMs);
+    events = drain(sub);
+    check(events.size() == 1, "crossed: one event");
+    if (events.size() == 1) {
+        check(events[0].type == ArbitrageEvent::Type::Crossed, "crossed: type");
+        check(events[0].buy_venue == Venue::Kraken && events[0].sell_venue == Venue::Coinbase, "crossed: direction");
+        check(events[0].ask == 100.0 && events[0].bid == 100.5, "crossed: prices");
+        check(events[0].depth == 1.5, "crossed: depth is min(ask size, bid size)");
+        check(std::fabs(events[0].net_edge_bps - 50.0) < 1e-9, "crossed: edge in bps of the ask");
+        check(std::string(events[0].pair) == "BTC-USD", "crossed: pair");
+    }
+
+    // Bid comes back to the ask: locked (ends the crossed episode without a Closed event)
+    monitor.onTopOfBook("BTC-USD", Venue::Coinbase, 100.0, 1.0, 101.0, 2.0, 1030 * kMs);
+    events = drain(sub);
+    check(events.size() == 1 && events[0].type == ArbitrageEvent::Type::Locked, "locked: one Locked event");
+
+    // Bid drops below: closed, duration measured from when the lock opened
+    monitor.onTopOfBook("BTC-USD", Venue::Coinbase, 99.0, 1.0, 101.0, 2.0, 1045 * kMs);
+    events = drain(sub);
+    check(events.size() == 1 && events[0].type == ArbitrageEvent::Type::Closed, "closed: one Closed event");
+    if (events.size() == 1) check(events[0].duration_ns == 15 * kMs, "closed: duration of the locked episode");
+
+    auto snapshot = monitor.snapshot();
+    const nlohmann::json* leg = findLeg(snapshot, "BTC-USD", "kraken", "coinbase");
+    check(leg != nullptr, "snapshot: leg present");
+    if (leg) {
+        const auto& stats = (*leg)["stats"];
+        check((*leg)["state"] == "closed", "snapshot: state closed");
+        check(stats["opportunities"] == 1, "stats: one crossed episode folded");
+        check(stats["profitable"] == 1, "stats: profitable with zero fees");
+        check(stats["max_duration_ns"].get<double>() == 20.0 * kMs, "stats: crossed for 20ms");
+        check(stats["max_depth"].get<double>() == 1.5, "stats: peak depth");
+        check(std::fabs(stats["max_net_edge_bps"].get<double>() - 50.0) < 1e-9, "stats: peak edge");
+    }
+    check(snapshot["events_published"] == 3, "three events published");
+}
+
+void testFeesMakeCrossUnprofitable() {
+    ArbitrageMonitor monitor;
+    monitor.setTakerFee(Venue::Coinbase, 30.0);
+    monitor.setTakerFee(Venue::Gemini, 30.0);
+    auto sub = monitor.subscribe(8);
+    monitor.onTopOfBook("ETH-USD", Venue::Gemini, 99.0, 1.0, 100.0, 1.0, 1 * kMs);
+    monitor.onTopOfBook("ETH-USD", Venue::Coinbase, 100.1, 1.0, 101.0, 1.0, 2 * kMs);
+    auto events = drain(sub);
+    check(events.size() == 1 && events[0].type == ArbitrageEvent::Type::Crossed, "fees: still reported as crossed");
+    if (events.size() == 1) check(events[0].net_edge_bps < 0.0, "fees: negative net edge");
+    monitor.onTopOfBook("ETH-USD", Venue::Coinbase, 99.5, 1.0, 101.0, 1.0, 3 * kMs);
+    auto snapshot = monitor.snapshot();
+    auto leg = findLeg(snapshot, "ETH-USD", "gemini", "coinbase");
+    check(leg && (*leg)["stats"]["opportunities"] == 1 && (*leg)["stats"]["profitable"] == 0, "fees: episode not profitable");
+}
+
+void testStaleQuoteIsIgnored() {
+    ArbitrageMonitor monitor;
+    monitor.setMaxQuoteAge(100 * kMs);
+    auto sub = monitor.subscribe(8);
+    monitor.onTopOfBook("SOL-USD", Venue::Kraken, 9.0, 1.0, 10.0, 1.0, 1000 * kMs);
+    // Fresh Gemini bid above a 500ms-old Kraken ask must not signal
+    monitor.onTopOfBook("SOL-USD", Venue::Gemini, 11.0, 1.0, 12.0, 1.0, 1500 * kMs);
+    check(drain(sub).empty(), "stale: no crossed signal against an old quote");
+    // Once Kraken refreshes, the cross is real
+    monitor.onTopOfBook("SOL-USD", Venue::Kraken, 9.0, 1.0, 10.0, 1.0, 1510 * kMs);
+    auto events = drain(sub);
+    check(events.size() == 1 && events[0].type == ArbitrageEvent::Type::Crossed, "stale: signal once both quotes are fresh");
+    // Kraken goes quiet; the next Gemini update closes the leg
+    monitor.onTopOfBook("SOL-USD", Venue::Gemini, 11.0, 1.0, 12.0, 1.0, 1700 * kMs);
+    events = drain(sub);
+    check(events.size() == 1 && events[0].type == ArbitrageEvent::Type::Closed, "stale: leg closes when a quote expires");
+}
+
+void testFullSubscriberDropsEvents() {
+    ArbitrageMonitor monitor;
+    for (Venue v : {Venue::Coinbase, Venue::Kraken, Venue::Gemini}) monitor.setTakerFee(v, 0.0);
+    auto sub = monitor.subscribe(2);
+    for (int i = 0; i < 4; ++i) {
+        double bid = i % 2 ? 102.0 : 99.0;
+        monitor.onTopOfBook("BTC-USD", Venue::Kraken, 98.0, 1.0, 100.0, 1.0, (10 + 2 * i) * kMs);
+        monitor.onTopOfBook("BTC-USD", Venue::Coinbase, bid, 1.0, 103.0, 1.0, (11 + 2 * i) * kMs);
+    }
+    auto snapshot = monitor.snapshot();
+    check(snapshot["events_dropped"].get<std::uint64_t>() > 0, "drop: overflow is counted");
+    check(drain(sub).size() == 2, "drop: ring holds its capacity");
+}
+
+} // namespace
+
+int main() {
+    testCrossedLockedClosedLifecycle();
+    testFeesMakeCrossUnprofitable();
+    testStaleQuoteIsIgnored();
+    testFullSubscriberDropsEvents();
+    return finish("arbitrage_monitor_test");
+}
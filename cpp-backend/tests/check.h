@@ -0,0 +1,31 @@
+#pragma once
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Minimal assert-style harness shared by the unit tests: failed checks are reported and
+// counted, and finish() turns the count into the process exit code.
+
+inline int failures = 0;
+
+inline void check(bool ok, const std::string& what) {
+    if (!ok) {
+        std::cerr << "FAIL: " << what << std::endl;
+        ++failures;
+    }
+}
+
+inline void checkNear(double actual, double expected, const std::string& what) {
+    check(std::fabs(actual - expected) < 1e-9, what + " (got " + std::to_string(actual) + ", want " + std::to_string(expected) + ")");
+}
+
+// Summary line and exit code for main()
+inline int finish(const std::string& name) {
+    if (failures) {
+        std::cerr << failures << " check(s) failed" << std::endl;
+        return EXIT_FAILURE;
+    }
+    std::cout << name << " passed" << std::endl;
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,84 @@
+#include "order_book.h"
+#include "check.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Checks top-of-book extraction and normalization for each venue's raw book shape.
+
+namespace {
+
+void checkTop(const TopOfBook& top, double bid, double bid_size, double ask, double ask_size, const std::string& what) {
+    check(std::fabs(top.bid - bid) < 1e-9 && std::fabs(top.bid_size - bid_size) < 1e-9 &&
+          std::fabs(top.ask - ask) < 1e-9 && std::fabs(top.ask_size - ask_size) < 1e-9, what);
+}
+
+void testCoinbase() {
+    auto book = nlohmann::json::parse(R"({"sequence":1,"bids":[["100.5","2.0",3],["100.0","1.0",1]],"asks":[["101.0","0.5",2]]})");
+    checkTop(OrderBook::parseTopOfBook(Venue::Coinbase, book), 100.5, 2.0, 101.0, 0.5, "coinbase top of book");
+    auto normalized = OrderBook::normalizeBook(Venue::Coinbase, book);
+    check(normalized["bids"].size() == 2 && normalized["asks"].size() == 1, "coinbase normalized level count");
+}
+
+void testKraken() {
+    auto book = nlohmann::json::parse(R"({"error":[],"result":{"XXBTZUSD":{
+        "asks":[["101.2","0.7",1700000000]],"bids":[["100.8","1.5",1700000000],["100.1","3.0",1700000000]]}}})");
+    checkTop(OrderBook::parseTopOfBook(Venue::Kraken, book), 100.8, 1.5, 101.2, 0.7, "kraken top of book");
+    auto normalized = OrderBook::normalizeBook(Venue::Kraken, book);
+    check(normalized["bids"].size() == 2 && normalized["bids"][0][0].get<std::string>() == "100.8", "kraken normalized bids");
+    auto error = nlohmann::json::parse(R"({"error":["EQuery:Unknown asset pair"]})");
+    checkTop(OrderBook::parseTopOfBook(Venue::Kraken, error), 0, 0, 0, 0, "kraken error response is empty");
+}
+
+void testGemini() {
+    auto book = nlohmann::json::parse(R"({
+        "bids":[{"price":"99.9","amount":"4.0","timestamp":"1700000000"}],
+        "asks":[{"price":"100.3","amount":"0.25","timestamp":"1700000000"},{"price":"100.4","amount":"1","timestamp":"1700000000"}]})");
+    checkTop(OrderBook::parseTopOfBook(Venue::Gemini, book), 99.9, 4.0, 100.3, 0.25, "gemini top of book");
+    auto normalized = OrderBook::normalizeBook(Venue::Gemini, book);
+    check(normalized["asks"].size() == 2, "gemini normalized asks");
+}
+
+void testNormalizedPrecision() {
+    // Satoshi-sized amounts and long prices must survive normalization unrounded
+    auto book = nlohmann::json::parse(R"({"bids":[["27123.456789012","0.00000123",1]],"asks":[[27123.5,1e-8,1]]})");
+    auto normalized = OrderBook::normalizeBook(Venue::Coinbase, book);
+    check(normalized["bids"][0][0].get<std::string>() == "27123.456789012", "venue price text kept");
+    check(normalized["bids"][0][1].get<std::string>() == "0.00000123", "venue size text kept");
+    checkNear(std::stod(normalized["asks"][0][0].get<std::string>()), 27123.5, "numeric price round-trips");
+    checkNear(std::stod(normalized["asks"][0][1].get<std::string>()) * 1e8, 1.0, "numeric size round-trips");
+}
+
+void testMalformed() {
+    checkTop(OrderBook::parseTopOfBook(Venue::Coinbase, nlohmann::json{{"error", "timeout"}}), 0, 0, 0, 0, "missing sides");
+    auto bad = nlohmann::json::parse(R"({"bids":[["abc","1"]],"asks":[]})");
+    checkTop(OrderBook::parseTopOfBook(Venue::Coinbase, bad), 0, 0, 0, 0, "unparseable price");
+    // Shapes from the wrong venue must not be misread
+    auto gemini = nlohmann::json::parse(R"({"bids":[{"price":"1","amount":"1"}],"asks":[]})");
+    checkTop(OrderBook::parseTopOfBook(Venue::Coinbase, gemini), 0, 0, 0, 0, "gemini shape read as coinbase");
+}
+
+void testMergeAcrossVenues() {
+    OrderBook ob(nullptr, nullptr, nullptr);
+    std::vector<nlohmann::json> books = {
+        OrderBook::normalizeBook(Venue::Coinbase, nlohmann::json::parse(R"({"bids":[["100","1"]],"asks":[["102","1"]]})")),
+        OrderBook::normalizeBook(Venue::Kraken, nlohmann::json::parse(R"({"error":[],"result":{"X":{"bids":[["101","1",0]],"asks":[["103","1",0]]}}})")),
+        OrderBook::normalizeBook(Venue::Gemini, nlohmann::json::parse(R"({"bids":[{"price":"99","amount":"1"}],"asks":[{"price":"101.5","amount":"1"}]})"))
+    };
+    auto merged = ob.mergeOrderBooks("BTC-USD", books);
+    check(merged["bids"].size() == 3 && merged["bids"][0][0].get<double>() == 101.0, "merge: best bid from kraken");
+    check(merged["asks"].size() == 3 && merged["asks"][0][0].get<double>() == 101.5, "merge: best ask from gemini");
+}
+
+} // namespace
+
+int main() {
+    testCoinbase();
+    testKraken();
+    testGemini();
+    testNormalizedPrecision();
+    testMalformed();
+    testMergeAcrossVenues();
+    return finish("order_book_test");
+}
@@ -0,0 +1,359 @@
+#include "pipeline.h"
+#include "check.h"
+#include <nlohmann/json.hpp>
+#include <atomic>
+#include <chrono>
+#include <cstring>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Checks how Pipeline reads each venue's order response, then drives a running Pipeline
+// against a loopback stub of all three venues: venue selection, deadline expiry, stop()
+// and the "Pipeline busy" paths.
+
+using json = nlohmann::json;
+
+namespace {
+
+// Minimal HTTP/1.1 server answering the Coinbase, Kraken and Gemini book and order
+// routes on one loopback port, with configurable tops of book and book latency.
+class VenueStub {
+public:
+    struct Quote {
+        double bid;
+        double ask;
+    };
+
+    VenueStub() {
+        listen_fd_ = ::socket(AF_INET, SOCK_STREAM, 0);
+        int one = 1;
+        ::setsockopt(listen_fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        addr.sin_port = 0;
+        ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::listen(listen_fd_, 64);
+        socklen_t len = sizeof(addr);
+        ::getsockname(listen_fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        accept_thread_ = std::thread([this]() { acceptLoop(); });
+    }
+
+    ~VenueStub() {
+        stopping_ = true;
+        ::shutdown(listen_fd_, SHUT_RDWR);
+        ::close(listen_fd_);
+        accept_thread_.join();
+        // The accept thread is gone, so the connection list no longer changes; workers
+        // still take mutex_ for quotes, so they are joined without holding it
+        for (int fd : connections_) ::shutdown(fd, SHUT_RDWR);
+        for (auto& t : workers_) t.join();
+        for (int fd : connections_) ::close(fd);
+    }
+
+    std::string url() const { return "http://127.0.0.1:" + std::to_string(port_); }
+
+    void setQuote(Venue venue, double bid, double ask) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        quotes_[static_cast<std::size_t>(venue)] = {bid, ask};
+    }
+
+    void setBookDelayMs(int ms) { book_delay_ms_ = ms; }
+
+    int orders(Venue venue) const { return orders_[static_cast<std::size_t>(venue)]; }
+    int totalOrders() const { return orders(Venue::Coinbase) + orders(Venue::Kraken) + orders(Venue::Gemini); }
+
+private:
+    int listen_fd_ = -1;
+    int port_ = 0;
+    std::atomic<bool> stopping_{false};
+    std::atomic<int> book_delay_ms_{0};
+    std::array<std::atomic<int>, kVenueCount> orders_{};
+    std::array<Quote, kVenueCount> quotes_{};
+    std::mutex mutex_;
+    std::vector<int> connections_;
+    std::vector<std::thread> workers_;
+    std::thread accept_thread_;
+
+    void acceptLoop() {
+        while (!stopping_) {
+            int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) return;
+            std::lock_guard<std::mutex> lock(mutex_);
+            connections_.push_back(fd);
+            workers_.emplace_back([this, fd]() { serve(fd); });
+        }
+    }
+
+    // One keep-alive connection: read each request in full, answer it, repeat until closed
+    void serve(int fd) {
+        std::string buffer;
+        char chunk[4096];
+        while (true) {
+            std::size_t header_end;
+            while ((header_end = buffer.find("\r\n\r\n")) == std::string::npos) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return;
+                buffer.append(chunk, static_cast<std::size_t>(n));
+            }
+            std::size_t body_length = 0;
+            std::size_t cl = buffer.find("Content-Length:");
+            if (cl != std::string::npos && cl < header_end) body_length = std::stoul(buffer.substr(cl + 15));
+            while (buffer.size() < header_end + 4 + body_length) {
+                ssize_t n = ::recv(fd, chunk, sizeof(chunk), 0);
+                if (n <= 0) return;
+                buffer.append(chunk, static_cast<std::size_t>(n));
+            }
+            std::string path = buffer.substr(buffer.find(' ') + 1);
+            path = path.substr(0, path.find(' '));
+            buffer.erase(0, header_end + 4 + body_length);
+
+            std::string body = respond(path).dump();
+            std::string response = "HTTP/1.1 200 OK\r\nContent-Type: application/json\r\nContent-Length: " +
+                                   std::to_string(body.size()) + "\r\n\r\n" + body;
+            if (::send(fd, response.data(), response.size(), MSG_NOSIGNAL) < 0) return;
+        }
+    }
+
+    json book(Venue venue) {
+        if (book_delay_ms_ > 0) std::this_thread::sleep_for(std::chrono::milliseconds(book_delay_ms_.load()));
+        Quote q;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            q = quotes_[static_cast<std::size_t>(venue)];
+        }
+        std::string bid = std::to_string(q.bid), ask = std::to_string(q.ask);
+        switch (venue) {
+        case Venue::Kraken: {
+            json result = {{"error", json::array()}};
+            result["result"]["XXBTZUSD"] = {{"bids", {{bid, "1.0", 1700000000}}}, {"asks", {{ask, "1.0", 1700000000}}}};
+            return result;
+        }
+        case Venue::Gemini:
+            return {{"bids", {{{"price", bid}, {"amount", "1.0"}}}}, {"asks", {{{"price", ask}, {"amount", "1.0"}}}}};
+        default:
+            return {{"bids", {{bid, "1.0", 1}}}, {"asks", {{ask, "1.0", 1}}}};
+        }
+    }
+
+    json respond(const std::string& path) {
+        if (path.rfind("/products/", 0) == 0) return book(Venue::Coinbase);
+        if (path.rfind("/0/public/Depth", 0) == 0) return book(Venue::Kraken);
+        if (path.rfind("/v1/book/", 0) == 0) return book(Venue::Gemini);
+        if (path == "/orders") {
+            ++orders_[static_cast<std::size_t>(Venue::Coinbase)];
+            return {{"id", "cb-1"}, {"status", "pending"}, {"settled", false}};
+        }
+        if (path == "/0/private/AddOrder") {
+            ++orders_[static_cast<std::size_t>(Venue::Kraken)];
+            json order = {{"error", json::array()}};
+            order["result"]["txid"] = {"KR-1"};
+            return order;
+        }
+        if (path == "/v1/order/new") {
+            ++orders_[static_cast<std::size_t>(Venue::Gemini)];
+            return {{"order_id", "1"}, {"executed_amount", "1"}};
+        }
+        return {{"error", "not found"}};
+    }
+};
+
+// Venue clients pointed at the stub
+struct Venues {
+    explicit Venues(const VenueStub& stub)
+        : coinbase("key", "secret", "passphrase", stub.url()),
+          kraken("key", "c2VjcmV0", stub.url()),
+          gemini("key", "secret", stub.url()) {}
+
+    CoinbaseAPI coinbase;
+    KrakenAPI kraken;
+    GeminiAPI gemini;
+};
+
+PipelineConfig testConfig() {
+    PipelineConfig config;
+    config.venue_timeout_ms = 2000;
+    config.trade_timeout_ms = 2000;
+    return config;
+}
+
+// Resolve a trade future, or an error if it never resolves
+json await(std::future<json>& reply, std::chrono::milliseconds timeout) {
+    if (reply.wait_for(timeout) != std::future_status::ready) return {{"error", "no reply"}};
+    return reply.get();
+}
+
+void testKraken() {
+    json accepted = json::parse(R"({"error": [], "result": {"descr": {"order": "buy 0.5 XBTUSD @ market"}, "txid": ["OABC12-DEF34-GHI567"]}})");
+    ExecutionReport report = Pipeline::parseExecution(Venue::Kraken, accepted, 0.5);
+    check(report.accepted, "kraken: empty error with txid is accepted");
+    checkNear(report.filled_quantity, 0.5, "kraken: acknowledged order booked as requested");
+
+    json rejected = json::parse(R"({"error": ["EOrder:Insufficient funds"]})");
+    report = Pipeline::parseExecution(Venue::Kraken, rejected, 0.5);
+    check(!report.accepted, "kraken: non-empty error is rejected");
+    checkNear(report.filled_quantity, 0.0, "kraken: rejection books nothing");
+    check(report.error.find("Insufficient funds") != std::string::npos, "kraken: venue reason kept");
+
+    json no_txid = json::parse(R"({"error": [], "result": {}})");
+    check(!Pipeline::parseExecution(Venue::Kraken, no_txid, 0.5).accepted, "kraken: missing txid is rejected");
+}
+
+void testCoinbase() {
+    json pending = json::parse(R"({"id": "d0c5340b", "product_id": "BTC-USD", "side": "buy", "type": "market", "status": "pending", "settled": false, "filled_size": "0"})");
+    ExecutionReport report = Pipeline::parseExecution(Venue::Coinbase, pending, 2.0);
+    check(report.accepted, "coinbase: id is accepted");
+    checkNear(report.filled_quantity, 2.0, "coinbase: pending order booked as requested");
+
+    json done = json::parse(R"({"id": "d0c5340b", "status": "done", "settled": true, "filled_size": "1.25"})");
+    report = Pipeline::parseExecution(Venue::Coinbase, done, 2.0);
+    check(report.accepted, "coinbase: done order is accepted");
+    checkNear(report.filled_quantity, 1.25, "coinbase: done order booked at filled_size");
+
+    json rejected = json::parse(R"({"message": "Insufficient funds"})");
+    report = Pipeline::parseExecution(Venue::Coinbase, rejected, 2.0);
+    check(!report.accepted, "coinbase: message without id is rejected");
+    checkNear(report.filled_quantity, 0.0, "coinbase: rejection books nothing");
+    check(report.error == "Insufficient funds", "coinbase: venue message kept");
+}
+
+void testGemini() {
+    json filled = json::parse(R"({"order_id": "106817811", "symbol": "btcusd", "side": "buy", "is_live": false, "is_cancelled": false, "executed_amount": "0.75"})");
+    ExecutionReport report = Pipeline::parseExecution(Venue::Gemini, filled, 1.0);
+    check(report.accepted, "gemini: order_id is accepted");
+    checkNear(report.filled_quantity, 0.75, "gemini: booked at executed_amount");
+
+    json unfilled = json::parse(R"({"order_id": "106817812", "is_cancelled": true, "executed_amount": "0"})");
+    report = Pipeline::parseExecution(Venue::Gemini, unfilled, 1.0);
+    check(report.accepted, "gemini: cancelled order still acknowledged");
+    checkNear(report.filled_quantity, 0.0, "gemini: nothing executed books nothing");
+
+    json rejected = json::parse(R"({"result": "error", "reason": "InsufficientFunds", "message": "Failed to place buy order"})");
+    report = Pipeline::parseExecution(Venue::Gemini, rejected, 1.0);
+    check(!report.accepted, "gemini: result error is rejected");
+    check(report.error == "InsufficientFunds", "gemini: venue reason kept");
+}
+
+void testTransportFailure() {
+    json failed = {{"error", "Timeout was reached"}};
+    for (Venue venue : {Venue::Coinbase, Venue::Kraken, Venue::Gemini}) {
+        ExecutionReport report = Pipeline::parseExecution(venue, failed, 1.0);
+        check(!report.accepted, std::string("transport: ") + venueName(venue) + " failure is rejected");
+        checkNear(report.filled_quantity, 0.0, std::string("transport: ") + venueName(venue) + " books nothing");
+    }
+}
+
+}
+
+void testRoutesToBestVenue() {
+    VenueStub stub;
+    stub.setQuote(Venue::Coinbase, 99.5, 101.0);
+    stub.setQuote(Venue::Kraken, 99.0, 100.5);
+    stub.setQuote(Venue::Gemini, 100.0, 102.0);
+    Venues venues(stub);
+    PositionEngine positions;
+    Pipeline pipeline(testConfig(), &venues.coinbase, &venues.kraken, &venues.gemini, nullptr, &positions);
+    pipeline.start();
+
+    auto buy = pipeline.submitTrade("BTC-USD", "BUY", 1.0);
+    json bought = await(buy, pipeline.replyTimeout());
+    check(bought.value("exchange", "") == "kraken", "routing: buy goes to the lowest ask");
+    checkNear(bought.value("best_price", 0.0), 100.5, "routing: buy at the kraken ask");
+    check(bought.value("accepted", false), "routing: kraken order accepted");
+
+    auto sell = pipeline.submitTrade("BTC-USD", "sell", 1.0);
+    json sold = await(sell, pipeline.replyTimeout());
+    check(sold.value("exchange", "") == "gemini", "routing: sell goes to the highest bid");
+    checkNear(sold.value("best_price", 0.0), 100.0, "routing: sell at the gemini bid");
+
+    pipeline.stop();
+    check(stub.orders(Venue::Kraken) == 1 && stub.orders(Venue::Gemini) == 1 && stub.orders(Venue::Coinbase) == 0,
+          "routing: one order per trade at the chosen venue");
+    json btc = positions.positions();
+    check(!btc.empty(), "routing: fills booked with the position engine");
+}
+
+void testDeadlineExpiry() {
+    VenueStub stub;
+    stub.setQuote(Venue::Coinbase, 99.0, 101.0);
+    stub.setQuote(Venue::Kraken, 99.0, 101.0);
+    stub.setQuote(Venue::Gemini, 99.0, 101.0);
+    stub.setBookDelayMs(400);
+    Venues venues(stub);
+    PipelineConfig config = testConfig();
+    config.trade_timeout_ms = 100;
+    Pipeline pipeline(config, &venues.coinbase, &venues.kraken, &venues.gemini, nullptr, nullptr);
+    pipeline.start();
+
+    auto trade = pipeline.submitTrade("BTC-USD", "buy", 1.0);
+    json reply = await(trade, std::chrono::milliseconds(300));
+    check(reply.value("timed_out", false), "deadline: trade times out before the books arrive");
+    // Let the late books reach the router; they must not place an order
+    std::this_thread::sleep_for(std::chrono::milliseconds(600));
+    pipeline.stop();
+    check(stub.totalOrders() == 0, "deadline: no order placed for an expired trade");
+}
+
+void testStopFailsPending() {
+    VenueStub stub;
+    stub.setBookDelayMs(1000);
+    Venues venues(stub);
+    Pipeline pipeline(testConfig(), &venues.coinbase, &venues.kraken, &venues.gemini, nullptr, nullptr);
+    pipeline.start();
+
+    auto trade = pipeline.submitTrade("BTC-USD", "buy", 1.0);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    pipeline.stop();
+    check(trade.wait_for(std::chrono::seconds(0)) == std::future_status::ready, "stop: pending trade resolved");
+    check(trade.get().value("error", "") == "Pipeline stopped", "stop: pending trade failed");
+    check(stub.totalOrders() == 0, "stop: no order placed");
+}
+
+void testBusy() {
+    VenueStub stub;
+    Venues venues(stub);
+    PipelineConfig config = testConfig();
+    Pipeline idle(config, &venues.coinbase, &venues.kraken, &venues.gemini, nullptr, nullptr);
+    auto before = idle.submitTrade("BTC-USD", "buy", 1.0);
+    check(before.get().value("error", "") == "Pipeline busy", "busy: not started");
+    idle.start();
+    idle.stop();
+    auto after = idle.submitTrade("BTC-USD", "buy", 1.0);
+    check(after.get().value("error", "") == "Pipeline busy", "busy: stopped");
+
+    // One fetch in flight per venue and a two-slot fetch ring: the fourth trade cannot be queued
+    stub.setBookDelayMs(500);
+    config.ring_capacity = 2;
+    config.max_in_flight = 1;
+    Pipeline full(config, &venues.coinbase, &venues.kraken, &venues.gemini, nullptr, nullptr);
+    full.start();
+    std::vector<std::future<json>> trades;
+    for (int i = 0; i < 4; ++i) trades.push_back(full.submitTrade("BTC-USD", "buy", 1.0));
+    bool busy = false;
+    for (auto& trade : trades) {
+        if (trade.wait_for(std::chrono::milliseconds(100)) != std::future_status::ready) continue;
+        busy = busy || trade.get().value("error", "") == "Pipeline busy";
+    }
+    check(busy, "busy: fetch ring full");
+    full.stop();
+}
+
+int main() {
+    testKraken();
+    testCoinbase();
+    testGemini();
+    testTransportFailure();
+    testRoutesToBestVenue();
+    testDeadlineExpiry();
+    testStopFailsPending();
+    testBusy();
+    return finish("pipeline_test");
+}
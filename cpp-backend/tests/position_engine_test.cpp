@@ -0,0 +1,113 @@
+#include "position_engine.h"
+#include "check.h"
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// Checks average-cost and realized/unrealized PnL accounting in PositionEngine.
+
+namespace {
+
+double field(const PositionEngine& engine, const std::string& symbol, const char* key) {
+    return engine.position(symbol)[key].get<double>();
+}
+
+void testAddBlendsAverageCost() {
+    PositionEngine engine;
+    engine.onFill("BTC-USD", "coinbase", "buy", 1.0, 100.0);
+    engine.onFill("BTC-USD", "coinbase", "buy", 3.0, 200.0);
+    checkNear(field(engine, "BTC-USD", "net"), 4.0, "add: net");
+    checkNear(field(engine, "BTC-USD", "avg_cost"), 175.0, "add: avg_cost");
+    checkNear(field(engine, "BTC-USD", "realized_pnl"), 0.0, "add: realized");
+    checkNear(field(engine, "BTC-USD", "unrealized_pnl"), 100.0, "add: unrealized at last fill");
+}
+
+void testPartialReduceKeepsAverageCost() {
+    PositionEngine engine;
+    engine.onFill("ETH-USD", "kraken", "buy", 4.0, 100.0);
+    engine.onFill("ETH-USD", "kraken", "sell", 1.0, 130.0);
+    checkNear(field(engine, "ETH-USD", "net"), 3.0, "reduce: net");
+    checkNear(field(engine, "ETH-USD", "avg_cost"), 100.0, "reduce: avg_cost unchanged");
+    checkNear(field(engine, "ETH-USD", "realized_pnl"), 30.0, "reduce: realized");
+}
+
+void testFullCloseFlattens() {
+    PositionEngine engine;
+    engine.onFill("SOL-USD", "gemini", "sell", 2.0, 50.0);
+    engine.onFill("SOL-USD", "gemini", "buy", 2.0, 40.0);
+    checkNear(field(engine, "SOL-USD", "net"), 0.0, "close: net");
+    checkNear(field(engine, "SOL-USD", "avg_cost"), 0.0, "close: avg_cost reset");
+    checkNear(field(engine, "SOL-USD", "realized_pnl"), 20.0, "close: short realized");
+    checkNear(field(engine, "SOL-USD", "unrealized_pnl"), 0.0, "close: unrealized");
+}
+
+void testFlipOpensAtFillPrice() {
+    PositionEngine engine;
+    engine.onFill("BTC-USD", "coinbase", "buy", 1.0, 100.0);
+    engine.onFill("BTC-USD", "coinbase", "sell", 3.0, 110.0);
+    checkNear(field(engine, "BTC-USD", "net"), -2.0, "flip: net");
+    checkNear(field(engine, "BTC-USD", "avg_cost"), 110.0, "flip: avg_cost is fill price");
+    checkNear(field(engine, "BTC-USD", "realized_pnl"), 10.0, "flip: realized on closed part only");
+    engine.onPrice("BTC-USD", 100.0);
+    checkNear(field(engine, "BTC-USD", "unrealized_pnl"), 20.0, "flip: short marked down");
+}
+
+void testFloatingPointResidueIsFlat() {
+    PositionEngine engine;
+    engine.onFill("ADA-USD", "internal", "buy", 0.1, 1.0);
+    engine.onFill("ADA-USD", "internal", "buy", 0.2, 1.0);
+    engine.onFill("ADA-USD", "internal", "sell", 0.3, 2.0);
+    check(field(engine, "ADA-USD", "net") == 0.0, "residue: net snapped to zero");
+    checkNear(field(engine, "ADA-USD", "avg_cost"), 0.0, "residue: avg_cost reset");
+    checkNear(field(engine, "ADA-USD", "realized_pnl"), 0.3, "residue: realized");
+    engine.onPrice("ADA-USD", 5.0);
+    check(field(engine, "ADA-USD", "unrealized_pnl") == 0.0, "residue: no phantom unrealized");
+}
+
+void testPriceTickMarksAndTotals() {
+    PositionEngine engine;
+    engine.onFill("BTC-USD", "coinbase", "buy", 2.0, 100.0);
+    engine.onFill("ETH-USD", "kraken", "sell", 1.0, 50.0);
+    engine.onPrice("BTC-USD", 110.0);
+    engine.onPrice("ETH-USD", 40.0);
+    auto pnl = engine.pnl();
+    checkNear(pnl["unrealized_pnl"].get<double>(), 30.0, "tick: portfolio unrealized");
+    checkNear(pnl["total_pnl"].get<double>(), 30.0, "tick: portfolio total");
+    check(pnl["fills"].get<std::size_t>() == 2, "tick: fill count");
+}
+
+void testRejectsInvalidFills() {
+    PositionEngine engine;
+    check(!engine.onFill("BTC-USD", "coinbase", "buy", 1.0, 0.0), "reject: zero price");
+    check(!engine.onFill("BTC-USD", "coinbase", "buy", 0.0, 100.0), "reject: zero quantity");
+    check(!engine.onFill("BTC-USD", "coinbase", "bye", 1.0, 100.0), "reject: unknown side");
+    check(engine.position("BTC-USD").is_null(), "reject: nothing recorded");
+    check(engine.onFill("BTC-USD", "coinbase", "Sell", 1.0, 100.0), "accept: mixed-case side");
+    checkNear(field(engine, "BTC-USD", "net"), -1.0, "accept: Sell is a sell");
+}
+
+void testVenueBreakdown() {
+    PositionEngine engine;
+    engine.onFill("BTC-USD", "coinbase", "buy", 2.0, 100.0);
+    engine.onFill("BTC-USD", "kraken", "sell", 1.0, 120.0);
+    auto pos = engine.position("BTC-USD");
+    checkNear(pos["venues"]["coinbase"]["net"].get<double>(), 2.0, "venue: coinbase net");
+    checkNear(pos["venues"]["kraken"]["net"].get<double>(), -1.0, "venue: kraken net");
+    checkNear(pos["net"].get<double>(), 1.0, "venue: aggregate net");
+    checkNear(pos["realized_pnl"].get<double>(), 20.0, "venue: aggregate nets across venues");
+}
+
+} // namespace
+
+int main() {
+    testAddBlendsAverageCost();
+    testPartialReduceKeepsAverageCost();
+    testFullCloseFlattens();
+    testFlipOpensAtFillPrice();
+    testFloatingPointResidueIsFlat();
+    testPriceTickMarksAndTotals();
+    testRejectsInvalidFills();
+    testVenueBreakdown();
+    return finish("position_engine_test");
+}
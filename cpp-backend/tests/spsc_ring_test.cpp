@@ -0,0 +1,79 @@
+#include "spsc_ring.h"
+#include "check.h"
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+
+// Checks capacity rounding, full/empty behaviour, wraparound and cross-thread ordering of SpscRing.
+
+namespace {
+
+void testCapacityRoundsUp() {
+    check(SpscRing<int>(1).capacity() == 2, "capacity: minimum of two");
+    check(SpscRing<int>(5).capacity() == 8, "capacity: rounded to power of two");
+    check(SpscRing<int>(8).capacity() == 8, "capacity: power of two kept");
+}
+
+void testFullAndEmpty() {
+    SpscRing<int> ring(4);
+    int value = -1;
+    check(!ring.tryPop(value), "empty: pop fails");
+    check(value == -1, "empty: output untouched");
+    for (int i = 0; i < 4; ++i) check(ring.tryPush(i), "fill: push " + std::to_string(i));
+    check(ring.size() == 4, "full: size equals capacity");
+    check(!ring.tryPush(99), "full: push fails");
+    check(ring.tryPop(value) && value == 0, "full: pop oldest");
+    check(ring.tryPush(4), "full: push succeeds after a pop");
+    for (int i = 1; i <= 4; ++i) check(ring.tryPop(value) && value == i, "drain: FIFO order " + std::to_string(i));
+    check(!ring.tryPop(value) && ring.size() == 0, "drain: empty again");
+}
+
+void testWraparound() {
+    SpscRing<int> ring(4);
+    int value = 0;
+    // Many laps around the buffer with varying fill levels
+    int next_in = 0, next_out = 0;
+    for (int lap = 0; lap < 1000; ++lap) {
+        int burst = 1 + lap % 4;
+        for (int i = 0; i < burst; ++i) check(ring.tryPush(next_in++), "wrap: push");
+        for (int i = 0; i < burst; ++i) {
+            check(ring.tryPop(value) && value == next_out, "wrap: order preserved");
+            ++next_out;
+        }
+    }
+    check(ring.size() == 0, "wrap: empty after laps");
+}
+
+void testCrossThreadOrdering() {
+    constexpr int kCount = 100000;
+    SpscRing<int> ring(64);
+    std::thread producer([&ring]() {
+        for (int i = 0; i < kCount; ++i) {
+            while (!ring.tryPush(i)) std::this_thread::yield();
+        }
+    });
+    int expected = 0;
+    bool ordered = true;
+    int value = 0;
+    while (expected < kCount) {
+        if (!ring.tryPop(value)) {
+            std::this_thread::yield();
+            continue;
+        }
+        if (value != expected) ordered = false;
+        ++expected;
+    }
+    producer.join();
+    check(ordered, "threads: every item received in order");
+}
+
+} // namespace
+
+int main() {
+    testCapacityRoundsUp();
+    testFullAndEmpty();
+    testWraparound();
+    testCrossThreadOrdering();
+    return finish("spsc_ring_test");
+}